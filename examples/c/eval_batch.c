@@ -0,0 +1,170 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+--*/
+
+/*
+  Compare Z3_model_eval_batch with one Z3_model_eval call per term and model.
+
+  The terms are the last nodes of a random DAG over integer constants built
+  from additions, subtractions, an uninterpreted function and if-then-else.
+  Usage: c_eval_batch [num_nodes [ite_percent]]
+*/
+#include<stdio.h>
+#include<stdlib.h>
+#include<time.h>
+#include<z3.h>
+
+#define NUM_VARS   50
+#define NUM_TERMS  200
+#define NUM_MODELS 200
+#define NUM_ROUNDS 3
+
+/**
+   \brief Exit gracefully in case of error.
+*/
+void error(char * msg)
+{
+    fprintf(stderr, "%s\n", msg);
+    exit(1);
+}
+
+double seconds_since(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+Z3_ast mk_int(Z3_context ctx, int v)
+{
+    return Z3_mk_int(ctx, v, Z3_mk_int_sort(ctx));
+}
+
+/**
+   \brief Create a random node over the nodes created so far.
+*/
+Z3_ast mk_node(Z3_context ctx, Z3_func_decl f, Z3_ast const * nodes, unsigned num_nodes, unsigned ite_percent)
+{
+    Z3_ast a = nodes[rand() % num_nodes];
+    Z3_ast b = nodes[rand() % num_nodes];
+    unsigned k = rand() % 100;
+    unsigned rest = (100 - ite_percent) / 3;
+    Z3_ast args[2];
+    if (k < ite_percent) {
+        Z3_ast fb = Z3_mk_app(ctx, f, 1, &b);
+        return Z3_mk_ite(ctx, Z3_mk_gt(ctx, a, b), a, Z3_mk_mod(ctx, fb, mk_int(ctx, 7)));
+    }
+    if (k < ite_percent + rest) {
+        args[0] = a; args[1] = b;
+        return Z3_mk_add(ctx, 2, args);
+    }
+    if (k < ite_percent + 2 * rest) {
+        args[0] = a; args[1] = mk_int(ctx, 2);
+        args[0] = Z3_mk_mul(ctx, 2, args);
+        args[1] = b;
+        return Z3_mk_sub(ctx, 2, args);
+    }
+    a = Z3_mk_mod(ctx, a, mk_int(ctx, 5));
+    return Z3_mk_app(ctx, f, 1, &a);
+}
+
+/**
+   \brief Create a model that fixes the constants and f on 0..4.
+*/
+Z3_model mk_model(Z3_context ctx, Z3_func_decl f, Z3_ast const * vars)
+{
+    Z3_solver s = Z3_mk_simple_solver(ctx);
+    Z3_model m;
+    int k;
+    unsigned i;
+    Z3_solver_inc_ref(ctx, s);
+    for (i = 0; i < NUM_VARS; ++i)
+        Z3_solver_assert(ctx, s, Z3_mk_eq(ctx, vars[i], mk_int(ctx, rand() % 19 - 9)));
+    for (k = 0; k < 5; ++k) {
+        Z3_ast kk = mk_int(ctx, k);
+        Z3_solver_assert(ctx, s, Z3_mk_eq(ctx, Z3_mk_app(ctx, f, 1, &kk), mk_int(ctx, rand() % 10)));
+    }
+    if (Z3_solver_check(ctx, s) != Z3_L_TRUE)
+        error("expected a model");
+    m = Z3_solver_get_model(ctx, s);
+    Z3_model_inc_ref(ctx, m);
+    Z3_solver_dec_ref(ctx, s);
+    return m;
+}
+
+int main(int argc, char ** argv)
+{
+    unsigned num_nodes   = argc > 1 ? atoi(argv[1]) : 3000;
+    unsigned ite_percent = argc > 2 ? atoi(argv[2]) : 25;
+    Z3_config cfg = Z3_mk_config();
+    Z3_context ctx = Z3_mk_context(cfg);
+    Z3_sort int_ty = Z3_mk_int_sort(ctx);
+    Z3_func_decl f = Z3_mk_func_decl(ctx, Z3_mk_string_symbol(ctx, "f"), 1, &int_ty, int_ty);
+    Z3_ast * nodes = (Z3_ast *) malloc(sizeof(Z3_ast) * (NUM_VARS + num_nodes));
+    Z3_model models[NUM_MODELS];
+    Z3_ast_vector pinned, terms;
+    double eval_time = 0, batch_time = 0;
+    int agree = 1;
+    unsigned i, j, n = 0, round;
+    char name[16];
+
+    Z3_del_config(cfg);
+    srand(1);
+    pinned = Z3_mk_ast_vector(ctx);
+    Z3_ast_vector_inc_ref(ctx, pinned);
+    for (i = 0; i < NUM_VARS; ++i) {
+        sprintf(name, "x%u", i);
+        nodes[n++] = Z3_mk_const(ctx, Z3_mk_string_symbol(ctx, name), int_ty);
+    }
+    for (i = 0; i < num_nodes; ++i) {
+        nodes[n] = mk_node(ctx, f, nodes, n, ite_percent);
+        Z3_ast_vector_push(ctx, pinned, nodes[n++]);
+    }
+    terms = Z3_mk_ast_vector(ctx);
+    Z3_ast_vector_inc_ref(ctx, terms);
+    for (i = n - NUM_TERMS; i < n; ++i)
+        Z3_ast_vector_push(ctx, terms, nodes[i]);
+    for (i = 0; i < NUM_MODELS; ++i)
+        models[i] = mk_model(ctx, f, nodes);
+
+    /* keep the best of a few rounds of each. */
+    for (round = 0; round < NUM_ROUNDS; ++round) {
+        Z3_ast_vector expected = Z3_mk_ast_vector(ctx);
+        Z3_ast_vector actual;
+        clock_t start;
+        double t;
+        Z3_ast_vector_inc_ref(ctx, expected);
+        start = clock();
+        for (i = 0; i < NUM_MODELS; ++i) {
+            for (j = 0; j < NUM_TERMS; ++j) {
+                Z3_ast v = 0;
+                if (!Z3_model_eval(ctx, models[i], Z3_ast_vector_get(ctx, terms, j), true, &v))
+                    error("evaluation failed");
+                Z3_ast_vector_push(ctx, expected, v);
+            }
+        }
+        t = seconds_since(start);
+        eval_time = round == 0 || t < eval_time ? t : eval_time;
+        start = clock();
+        actual = Z3_model_eval_batch(ctx, terms, NUM_MODELS, models, true);
+        t = seconds_since(start);
+        batch_time = round == 0 || t < batch_time ? t : batch_time;
+        Z3_ast_vector_inc_ref(ctx, actual);
+        for (i = 0; i < NUM_MODELS * NUM_TERMS; ++i)
+            agree &= Z3_is_eq_ast(ctx, Z3_ast_vector_get(ctx, expected, i), Z3_ast_vector_get(ctx, actual, i));
+        Z3_ast_vector_dec_ref(ctx, actual);
+        Z3_ast_vector_dec_ref(ctx, expected);
+    }
+
+    printf("%u nodes, %u%% if-then-else, %u terms in %u models\n", num_nodes, ite_percent, NUM_TERMS, NUM_MODELS);
+    printf("Z3_model_eval:       %.3fs\n", eval_time);
+    printf("Z3_model_eval_batch: %.3fs (%.1fx)\n", batch_time, batch_time > 0 ? eval_time / batch_time : 0.0);
+    printf("results %s\n", agree ? "agree" : "DIFFER");
+
+    for (i = 0; i < NUM_MODELS; ++i)
+        Z3_model_dec_ref(ctx, models[i]);
+    Z3_ast_vector_dec_ref(ctx, terms);
+    Z3_ast_vector_dec_ref(ctx, pinned);
+    free(nodes);
+    Z3_del_context(ctx);
+    return agree ? 0 : 1;
+}
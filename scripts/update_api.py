@@ -38,6 +38,7 @@ IN_ARRAY    = 3
 OUT_ARRAY   = 4
 INOUT_ARRAY = 5
 OUT_MANAGED_ARRAY  = 6
+FN_PTR      = 7
 
 # Primitive Types
 VOID       = 0
@@ -172,6 +173,11 @@ def _inout_array(sz, ty):
 def _out_managed_array(sz,ty):
     return (OUT_MANAGED_ARRAY, ty, 0, sz)
 
+# ty is the name of a function type declared in the API header,
+# and of the ctypes prototype declared in the Python preamble.
+def _fnptr(ty):
+    return (FN_PTR, ty)
+
 
 def param_kind(p):
     return p[0]
@@ -192,6 +198,8 @@ def param2str(p):
         return "%s*" % type2str(param_type(p))
     elif param_kind(p) == OUT:
         return "%s*" % type2str(param_type(p))
+    elif param_kind(p) == FN_PTR:
+        return "%s*" % param_type(p)
     else:
         return type2str(param_type(p))
 
@@ -254,6 +262,8 @@ def param2javaw(p):
 def param2pystr(p):
     if param_kind(p) == IN_ARRAY or param_kind(p) == OUT_ARRAY or param_kind(p) == IN_ARRAY or param_kind(p) == INOUT_ARRAY or param_kind(p) == OUT:
         return "ctypes.POINTER(%s)" % type2pystr(param_type(p))
+    elif param_kind(p) == FN_PTR:
+        return param_type(p)
     else:
         return type2pystr(param_type(p))
 
@@ -816,7 +826,7 @@ def mk_log_header(file, name, params):
 def log_param(p):
     kind = param_kind(p)
     ty   = param_type(p)
-    return is_obj(ty) and (kind == OUT or kind == INOUT or kind == OUT_ARRAY or kind == INOUT_ARRAY)
+    return (kind == OUT or kind == INOUT or kind == OUT_ARRAY or kind == INOUT_ARRAY) and is_obj(ty)
 
 def log_result(result, params):
     for p in params:
@@ -917,7 +927,9 @@ def def_API(name, result, params):
     global API2Id, next_id
     global log_h, log_c
     mk_py_binding(name, result, params)
-    reg_dotnet(name, result, params)
+    # callbacks are only marshalled by the Python bindings.
+    if not any(param_kind(p) == FN_PTR for p in params):
+        reg_dotnet(name, result, params)
     API2Id[next_id] = name
     mk_log_header(log_h, name, params)
     log_h.write(';\n')
@@ -970,8 +982,16 @@ def def_API(name, result, params):
             elif ty == PRINT_MODE or ty == ERROR_CODE:
                 log_c.write("  U(static_cast<unsigned>(a%s));\n" % i)
                 exe_c.write("static_cast<%s>(in.get_uint(%s))" % (type2str(ty), i))
+            elif ty == VOID_PTR:
+                # user state cannot be replayed.
+                log_c.write("  P(0);\n")
+                exe_c.write("nullptr")
             else:
                 error("unsupported parameter for %s, %s" % (name, p))
+        elif kind == FN_PTR:
+            # neither can callbacks.
+            log_c.write("  P(0);\n")
+            exe_c.write("nullptr")
         elif kind == INOUT:
             error("unsupported parameter for %s, %s" % (name, p))
         elif kind == OUT:
@@ -1817,6 +1837,12 @@ _error_handler_type  = ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.c_uint)
 _lib.Z3_set_error_handler.restype  = None
 _lib.Z3_set_error_handler.argtypes = [ContextObj, _error_handler_type]
 
+Z3_push_eh  = ctypes.CFUNCTYPE(None, ctypes.c_void_p)
+Z3_pop_eh   = ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.c_uint)
+Z3_fixed_eh = ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_uint, ctypes.c_void_p)
+Z3_final_eh = ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.c_void_p)
+Z3_eq_eh    = ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_uint, ctypes.c_uint)
+
 """
   )
 
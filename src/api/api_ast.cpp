@@ -40,6 +40,7 @@ Revision History:
 #include "util/cancel_eh.h"
 #include "util/scoped_timer.h"
 #include "ast/pp_params.hpp"
+#include "ast/rewriter/rewriter_params.hpp"
 #include "ast/expr_abstract.h"
 
 
@@ -745,6 +746,9 @@ extern "C" {
         bool     use_ctrl_c  = p.get_bool("ctrl_c", false);
         th_rewriter m_rw(m, p);
         m_rw.set_solver(alloc(api::seq_expr_solver, m, p));
+        unsigned memo_size = rewriter_params(p).memo_size();
+        if (memo_size > 0)
+            m_rw.set_memo(mk_c(c)->get_simplify_memo(memo_size));
         expr_ref    result(m);
         cancel_eh<reslimit> eh(m.limit());
         api::context::set_interruptable si(*(mk_c(c)), eh);
@@ -118,6 +118,12 @@ namespace api {
         }
     }
 
+    th_rewriter_memo* context::get_simplify_memo(unsigned max_size) {
+        if (!m_simplify_memo)
+            m_simplify_memo = alloc(th_rewriter_memo, m(), max_size);
+        return m_simplify_memo.get();
+    }
+
     context::set_interruptable::set_interruptable(context & ctx, event_handler & i):
         m_ctx(ctx) {
         lock_guard lock(ctx.m_mux);
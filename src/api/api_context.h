@@ -34,6 +34,7 @@ Revision History:
 #include "ast/recfun_decl_plugin.h"
 #include "ast/special_relations_decl_plugin.h"
 #include "ast/rewriter/seq_rewriter.h"
+#include "ast/rewriter/th_rewriter.h"
 #include "smt/params/smt_params.h"
 #include "smt/smt_kernel.h"
 #include "smt/smt_solver.h"
@@ -96,6 +97,7 @@ namespace api {
 
         ast_ref_vector             m_last_result; //!< used when m_user_ref_count == true
         ast_ref_vector             m_ast_trail;   //!< used when m_user_ref_count == false
+        ref<th_rewriter_memo>      m_simplify_memo; //!< results of Z3_simplify shared across calls (rewriter.memo_size > 0)
 
         ref<api::object>           m_last_obj; //!< reference to the last API object returned by the APIs
         u_map<api::object*>        m_allocated_objects; // !< table containing current set of allocated API objects
@@ -157,6 +159,7 @@ namespace api {
         datatype_util& dtutil() { return m_dt_plugin->u(); }
         seq_util& sutil() { return m_sutil; }
         recfun::util& recfun() { return m_recfun; }
+        th_rewriter_memo* get_simplify_memo(unsigned max_size);
         family_id get_basic_fid() const { return m_basic_fid; }
         family_id get_array_fid() const { return m_array_fid; }
         family_id get_arith_fid() const { return m_arith_fid; }
@@ -26,6 +26,7 @@ Revision History:
 #include "model/model_smt2_pp.h"
 #include "model/model_params.hpp"
 #include "model/model_evaluator_params.hpp"
+#include "model/model_program.h"
 
 extern "C" {
 
@@ -174,6 +175,37 @@ extern "C" {
         Z3_CATCH_RETURN(false);
     }
 
+    Z3_ast_vector Z3_API Z3_model_eval_batch(Z3_context c, Z3_ast_vector ts, unsigned num_models, Z3_model const ms[], bool model_completion) {
+        Z3_TRY;
+        LOG_Z3_model_eval_batch(c, ts, num_models, ms, model_completion);
+        RESET_ERROR_CODE();
+        ast_manager& mgr = mk_c(c)->m();
+        model_program prog(mgr);
+        for (ast* t : to_ast_vector_ref(ts)) {
+            if (!is_expr(t)) {
+                SET_ERROR_CODE(Z3_INVALID_ARG, "expression expected");
+                RETURN_Z3(nullptr);
+            }
+            prog.add(to_expr(t));
+        }
+        Z3_ast_vector_ref * v = alloc(Z3_ast_vector_ref, *mk_c(c), mgr);
+        mk_c(c)->save_object(v);
+        expr_ref_vector values(mgr);
+        params_ref p;
+        for (unsigned i = 0; i < num_models; ++i) {
+            CHECK_NON_NULL(ms[i], nullptr);
+            model * _m = to_model_ref(ms[i]);
+            if (!_m->has_solver()) {
+                _m->set_solver(alloc(api::seq_expr_solver, mgr, p));
+            }
+            prog.run(*_m, model_completion, values);
+            for (expr* val : values)
+                v->m_ast_vector.push_back(val);
+        }
+        RETURN_Z3(of_ast_vector(v));
+        Z3_CATCH_RETURN(nullptr);
+    }
+
     unsigned Z3_API Z3_model_get_num_sorts(Z3_context c, Z3_model m) {
         Z3_TRY;
         LOG_Z3_model_get_num_sorts(c, m);
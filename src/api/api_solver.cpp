@@ -850,4 +850,84 @@ extern "C" {
     }
 
 
+    void Z3_API Z3_solver_propagate_init(
+        Z3_context  c, 
+        Z3_solver   s, 
+        void*       user_context,
+        Z3_push_eh* push_eh,
+        Z3_pop_eh*  pop_eh) {
+        Z3_TRY;
+        LOG_Z3_solver_propagate_init(c, s, user_context, push_eh, pop_eh);
+        RESET_ERROR_CODE();
+        init_solver(c, s);
+        user_propagator::push_eh_t _push = push_eh;
+        user_propagator::pop_eh_t _pop = pop_eh;
+        to_solver_ref(s)->user_propagate_init(user_context, _push, _pop);
+        Z3_CATCH;
+    }
+
+    void Z3_API Z3_solver_propagate_fixed(
+        Z3_context  c, 
+        Z3_solver   s, 
+        Z3_fixed_eh* fixed_eh) {
+        Z3_TRY;
+        LOG_Z3_solver_propagate_fixed(c, s, fixed_eh);
+        RESET_ERROR_CODE();
+        user_propagator::fixed_eh_t _fixed = [=](void* ctx, user_propagator::callback* cb, unsigned id, expr* value) {
+            fixed_eh(ctx, reinterpret_cast<Z3_solver_callback>(cb), id, of_ast(value));
+        };
+        to_solver_ref(s)->user_propagate_register_fixed(_fixed);
+        Z3_CATCH;
+    }
+
+    void Z3_API Z3_solver_propagate_final(
+        Z3_context  c, 
+        Z3_solver   s, 
+        Z3_final_eh* final_eh) {
+        Z3_TRY;
+        LOG_Z3_solver_propagate_final(c, s, final_eh);
+        RESET_ERROR_CODE();
+        user_propagator::final_eh_t _final = [=](void* ctx, user_propagator::callback* cb) {
+            final_eh(ctx, reinterpret_cast<Z3_solver_callback>(cb));
+        };
+        to_solver_ref(s)->user_propagate_register_final(_final);
+        Z3_CATCH;
+    }
+
+    void Z3_API Z3_solver_propagate_eq(
+        Z3_context  c, 
+        Z3_solver   s, 
+        Z3_eq_eh*   eq_eh) {
+        Z3_TRY;
+        LOG_Z3_solver_propagate_eq(c, s, eq_eh);
+        RESET_ERROR_CODE();
+        user_propagator::eq_eh_t _eq = [=](void* ctx, user_propagator::callback* cb, unsigned x, unsigned y) {
+            eq_eh(ctx, reinterpret_cast<Z3_solver_callback>(cb), x, y);
+        };
+        to_solver_ref(s)->user_propagate_register_eq(_eq);
+        Z3_CATCH;
+    }
+
+    unsigned Z3_API Z3_solver_propagate_register(Z3_context c, Z3_solver s, Z3_ast e) {
+        Z3_TRY;
+        LOG_Z3_solver_propagate_register(c, s, e);
+        RESET_ERROR_CODE();
+        CHECK_IS_EXPR(e, 0);
+        return to_solver_ref(s)->user_propagate_register(to_expr(e));
+        Z3_CATCH_RETURN(0);
+    }
+
+    void Z3_API Z3_solver_propagate_consequence(
+        Z3_context c, Z3_solver_callback s, 
+        unsigned num_fixed, unsigned const* fixed_ids, 
+        unsigned num_eqs, unsigned const* eq_lhs, unsigned const* eq_rhs, 
+        Z3_ast conseq) {
+        Z3_TRY;
+        LOG_Z3_solver_propagate_consequence(c, s, num_fixed, fixed_ids, num_eqs, eq_lhs, eq_rhs, conseq);
+        RESET_ERROR_CODE();
+        CHECK_IS_EXPR(conseq, );
+        reinterpret_cast<user_propagator::callback*>(s)->propagate_cb(num_fixed, fixed_ids, num_eqs, eq_lhs, eq_rhs, to_expr(conseq));
+        Z3_CATCH;
+    }
+
 };
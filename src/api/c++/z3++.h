@@ -27,6 +27,8 @@ Notes:
 #include<sstream>
 #include<z3.h>
 #include<limits.h>
+#include<functional>
+#include<vector>
 
 #undef min
 #undef max
@@ -3565,7 +3567,130 @@ namespace z3 {
         return expr(ctx(), r);
     }
 
+    class user_propagator_base {
+    public:
+        typedef std::function<void(unsigned, expr const&)> fixed_eh_t;
+        typedef std::function<void(void)> final_eh_t;
+        typedef std::function<void(unsigned, unsigned)> eq_eh_t;
+
+    private:
+        final_eh_t m_final_eh;
+        eq_eh_t    m_eq_eh;
+        fixed_eh_t m_fixed_eh;
+        solver*    s;
+        Z3_context c;
+        Z3_solver_callback cb { nullptr };
+
+        struct scoped_cb {
+            user_propagator_base& p;
+            scoped_cb(void* _p, Z3_solver_callback cb):p(*static_cast<user_propagator_base*>(_p)) {
+                p.cb = cb;
+            }
+            ~scoped_cb() { 
+                p.cb = nullptr; 
+            }
+        };
+
+        static void push_eh(void* p) {
+            static_cast<user_propagator_base*>(p)->push();
+        }
+
+        static void pop_eh(void* p, unsigned num_scopes) {
+            static_cast<user_propagator_base*>(p)->pop(num_scopes);
+        }
+
+        static void eq_eh(void* p, Z3_solver_callback cb, unsigned x, unsigned y) {
+            scoped_cb _cb(p, cb);
+            static_cast<user_propagator_base*>(p)->m_eq_eh(x, y);
+        }
+
+        static void final_eh(void* p, Z3_solver_callback cb) {
+            scoped_cb _cb(p, cb);
+            static_cast<user_propagator_base*>(p)->m_final_eh();
+        }
+
+        static void fixed_eh(void* _p, Z3_solver_callback cb, unsigned id, Z3_ast _value) {
+            user_propagator_base* p = static_cast<user_propagator_base*>(_p);
+            scoped_cb _cb(p, cb);
+            expr value(p->s->ctx(), _value);
+            p->m_fixed_eh(id, value);
+        }
+
+    public:
+        user_propagator_base(solver* s): s(s), c(s->ctx()) {
+            Z3_solver_propagate_init(c, *s, this, push_eh, pop_eh);
+            s->check_error();
+        }
+
+        virtual void push() = 0;
+        virtual void pop(unsigned num_scopes) = 0;
+
+        virtual ~user_propagator_base() {}
 
+        /**
+           \brief register callbacks.
+           Callbacks can only be registered with user_propagators
+           that were created using a solver.
+        */
+
+        void fixed(fixed_eh_t& f) {
+            m_fixed_eh = f;
+            Z3_solver_propagate_fixed(c, *s, fixed_eh);
+            s->check_error();
+        }
+
+        void eq(eq_eh_t& f) {
+            m_eq_eh = f;
+            Z3_solver_propagate_eq(c, *s, eq_eh);
+            s->check_error();
+        }
+
+        void final(final_eh_t& f) {
+            m_final_eh = f;
+            Z3_solver_propagate_final(c, *s, final_eh);
+            s->check_error();
+        }
+
+        /**
+           \brief tracks \c e by a unique identifier that is returned by the call.
+
+           If the \c fixed() callback is registered and if \c e is a Boolean,
+           then the \c fixed() callback is invoked when \c e is bound to a value.
+           If the \c eq() callback is registered, then equalities between registered
+           expressions are reported.
+        */
+        unsigned add(expr const& e) {
+            unsigned id = Z3_solver_propagate_register(c, *s, e);
+            s->check_error();
+            return id;
+        }
+
+        void conflict(unsigned num_fixed, unsigned const* fixed) {
+            assert(cb);
+            expr conseq = s->ctx().bool_val(false);
+            Z3_solver_propagate_consequence(c, cb, num_fixed, fixed, 0, nullptr, nullptr, conseq);
+            s->check_error();
+        }
+
+        void propagate(unsigned num_fixed, unsigned const* fixed, expr const& conseq) {
+            assert(cb);
+            Z3_solver_propagate_consequence(c, cb, num_fixed, fixed, 0, nullptr, nullptr, conseq);
+            s->check_error();
+        }
+
+        void propagate(std::vector<unsigned> const& fixed,
+                       std::vector<unsigned> const& lhs,
+                       std::vector<unsigned> const& rhs,
+                       expr const& conseq) {
+            assert(cb);
+            assert(lhs.size() == rhs.size());
+            Z3_solver_propagate_consequence(c, cb,
+                                            static_cast<unsigned>(fixed.size()), fixed.data(),
+                                            static_cast<unsigned>(lhs.size()), lhs.data(), rhs.data(),
+                                            conseq);
+            s->check_error();
+        }
+    };
 
 }
 
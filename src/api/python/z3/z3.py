@@ -6959,6 +6959,143 @@ def SimpleSolver(ctx=None, logFile=None):
     ctx = _get_ctx(ctx)
     return Solver(Z3_mk_simple_solver(ctx.ref()), ctx, logFile)
 
+#########################################
+#
+# User Propagator
+#
+#########################################
+
+class PropClosures:
+    def __init__(self):
+        self.bases = {}
+        self.next_id = 1
+
+    def get(self, ctx):
+        return self.bases[ctx]
+
+    def insert(self, base):
+        id = self.next_id
+        self.next_id += 1
+        self.bases[id] = base
+        return id
+
+    def remove(self, id):
+        self.bases.pop(id, None)
+
+_prop_closures = PropClosures()
+
+def _user_prop_push(ctx):
+    _prop_closures.get(ctx).push()
+
+def _user_prop_pop(ctx, num_scopes):
+    _prop_closures.get(ctx).pop(num_scopes)
+
+def _to_Ast(ptr):
+    ast = Ast(ptr)
+    super(ctypes.c_void_p, ast).__init__(ptr)
+    return ast
+
+def _user_prop_fixed(ctx, cb, id, value):
+    prop = _prop_closures.get(ctx)
+    prop.cb = cb
+    try:
+        prop.fixed(id, _to_expr_ref(_to_Ast(value), prop.ctx()))
+    finally:
+        prop.cb = None
+
+def _user_prop_final(ctx, cb):
+    prop = _prop_closures.get(ctx)
+    prop.cb = cb
+    try:
+        prop.final()
+    finally:
+        prop.cb = None
+
+def _user_prop_eq(ctx, cb, x, y):
+    prop = _prop_closures.get(ctx)
+    prop.cb = cb
+    try:
+        prop.eq(x, y)
+    finally:
+        prop.cb = None
+
+_user_prop_push_eh  = Z3_push_eh(_user_prop_push)
+_user_prop_pop_eh   = Z3_pop_eh(_user_prop_pop)
+_user_prop_fixed_eh = Z3_fixed_eh(_user_prop_fixed)
+_user_prop_final_eh = Z3_final_eh(_user_prop_final)
+_user_prop_eq_eh    = Z3_eq_eh(_user_prop_eq)
+
+class UserPropagateBase:
+    """Base class for user propagators.
+
+    A subclass implements push() and pop(num_scopes), registers the
+    callbacks it is interested in using add_fixed, add_final and add_eq,
+    and registers terms using add. Consequences are propagated from
+    within callbacks using propagate and conflict.
+    """
+
+    def __init__(self, s):
+        self.solver = s
+        self.cb = None
+        self.id = _prop_closures.insert(self)
+        self.fixed = None
+        self.final = None
+        self.eq = None
+        Z3_solver_propagate_init(self.ctx_ref(), s.solver, ctypes.c_void_p(self.id), _user_prop_push_eh, _user_prop_pop_eh)
+
+    def __del__(self):
+        if _prop_closures is not None:
+            _prop_closures.remove(self.id)
+
+    def ctx(self):
+        return self.solver.ctx
+
+    def ctx_ref(self):
+        return self.ctx().ref()
+
+    def add_fixed(self, fixed):
+        assert not self.fixed
+        self.fixed = fixed
+        Z3_solver_propagate_fixed(self.ctx_ref(), self.solver.solver, _user_prop_fixed_eh)
+
+    def add_final(self, final):
+        assert not self.final
+        self.final = final
+        Z3_solver_propagate_final(self.ctx_ref(), self.solver.solver, _user_prop_final_eh)
+
+    def add_eq(self, eq):
+        assert not self.eq
+        self.eq = eq
+        Z3_solver_propagate_eq(self.ctx_ref(), self.solver.solver, _user_prop_eq_eh)
+
+    def push(self):
+        raise Z3Exception("push needs to be overwritten")
+
+    def pop(self, num_scopes):
+        raise Z3Exception("pop needs to be overwritten")
+
+    def add(self, e):
+        """Register e with the propagator and return its identifier."""
+        return Z3_solver_propagate_register(self.ctx_ref(), self.solver.solver, e.as_ast())
+
+    def propagate(self, e, ids, eqs = []):
+        """Propagate e, justified by the fixed values of ids and the equalities eqs."""
+        num_fixed = len(ids)
+        _ids = (ctypes.c_uint * num_fixed)()
+        for i in range(num_fixed):
+            _ids[i] = ids[i]
+        num_eqs = len(eqs)
+        _lhs = (ctypes.c_uint * num_eqs)()
+        _rhs = (ctypes.c_uint * num_eqs)()
+        for i in range(num_eqs):
+            _lhs[i] = eqs[i][0]
+            _rhs[i] = eqs[i][1]
+        Z3_solver_propagate_consequence(self.ctx_ref(), ctypes.c_void_p(self.cb), num_fixed, _ids, num_eqs, _lhs, _rhs, e.as_ast())
+
+    def conflict(self, ids, eqs = []):
+        """Add a conflict justified by the fixed values of ids and the equalities eqs."""
+        self.propagate(BoolVal(False, self.ctx()), ids, eqs)
+
 #########################################
 #
 # Fixedpoint
@@ -121,3 +121,7 @@ class FuncEntryObj(ctypes.c_void_p):
 class RCFNumObj(ctypes.c_void_p):
   def __init__(self, e): self._as_parameter_ = e
   def from_param(obj): return obj
+
+class SolverCallbackObj(ctypes.c_void_p):
+  def __init__(self, cb): self._as_parameter_ = cb
+  def from_param(obj): return obj
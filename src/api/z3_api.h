@@ -26,6 +26,7 @@ DEFINE_TYPE(Z3_tactic);
 DEFINE_TYPE(Z3_probe);
 DEFINE_TYPE(Z3_stats);
 DEFINE_TYPE(Z3_solver);
+DEFINE_TYPE(Z3_solver_callback);
 DEFINE_TYPE(Z3_ast_vector);
 DEFINE_TYPE(Z3_ast_map);
 DEFINE_TYPE(Z3_apply_result);
@@ -68,6 +69,7 @@ DEFINE_TYPE(Z3_rcf_num);
    - \c Z3_probe: function/predicate used to inspect a goal and collect information that may be used to decide which solver and/or preprocessing step will be used.
    - \c Z3_apply_result: collection of subgoals resulting from applying of a tactic to a goal.
    - \c Z3_solver: (incremental) solver, possibly specialized by a particular tactic or logic.
+   - \c Z3_solver_callback: solver callback object passed to user propagators.
    - \c Z3_stats: statistical data for a solver.
 */
 
@@ -1406,6 +1408,7 @@ typedef enum
   def_Type('OPTIMIZE',         'Z3_optimize',         'OptimizeObj')
   def_Type('PARAM_DESCRS',     'Z3_param_descrs',     'ParamDescrs')
   def_Type('RCF_NUM',          'Z3_rcf_num',          'RCFNumObj')
+  def_Type('SOLVER_CALLBACK',   'Z3_solver_callback',  'SolverCallbackObj')
 */
 
 /**
@@ -5101,6 +5104,21 @@ extern "C" {
     */
     Z3_bool_opt Z3_API Z3_model_eval(Z3_context c, Z3_model m, Z3_ast t, bool model_completion, Z3_ast * v);
 
+    /**
+       \brief Evaluate the terms \c ts in each of the models \c ms.
+
+       The terms are compiled once and the compiled form is reused for every model.
+       The result contains \c num_models times the size of \c ts values; the value of
+       the \c j'th term in the \c i'th model is at position \c i * size(ts) + j.
+
+       \c model_completion has the same meaning as for \c Z3_model_eval.
+
+       \sa Z3_model_eval
+
+       def_API('Z3_model_eval_batch', AST_VECTOR, (_in(CONTEXT), _in(AST_VECTOR), _in(UINT), _in_array(2, MODEL), _in(BOOL)))
+    */
+    Z3_ast_vector Z3_API Z3_model_eval_batch(Z3_context c, Z3_ast_vector ts, unsigned num_models, Z3_model const ms[], bool model_completion);
+
     /**
        \brief Return the interpretation (i.e., assignment) of constant \c a in the model \c m.
        Return \c NULL, if the model does not assign an interpretation for \c a.
@@ -6477,6 +6495,82 @@ extern "C" {
     */
     void Z3_API Z3_solver_get_levels(Z3_context c, Z3_solver s, Z3_ast_vector literals, unsigned sz,  unsigned levels[]);
 
+    /** \brief Callbacks of a user propagator. */
+    typedef void Z3_push_eh(void* ctx);
+    typedef void Z3_pop_eh(void* ctx, unsigned num_scopes);
+    typedef void Z3_fixed_eh(void* ctx, Z3_solver_callback cb, unsigned id, Z3_ast value);
+    typedef void Z3_eq_eh(void* ctx, Z3_solver_callback cb, unsigned x, unsigned y);
+    typedef void Z3_final_eh(void* ctx, Z3_solver_callback cb);
+
+    /**
+       \brief register a user-propagator with the solver.
+
+       \param c - context.
+       \param s - solver object.
+       \param user_context - a context used to maintain state for callbacks.
+       \param push_eh - a callback invoked when scopes are pushed
+       \param pop_eh - a callback invoked when scopes are popped
+
+       The user propagator is attached to the SMT core.
+
+       def_API('Z3_solver_propagate_init', VOID, (_in(CONTEXT), _in(SOLVER), _in(VOID_PTR), _fnptr('Z3_push_eh'), _fnptr('Z3_pop_eh')))
+    */
+    void Z3_API Z3_solver_propagate_init(
+        Z3_context  c, 
+        Z3_solver   s, 
+        void*       user_context,
+        Z3_push_eh* push_eh,
+        Z3_pop_eh*  pop_eh);
+
+    /**
+       \brief register a callback for when an expression is bound to a fixed value.
+       Fixed values are reported for registered Boolean expressions.
+
+       def_API('Z3_solver_propagate_fixed', VOID, (_in(CONTEXT), _in(SOLVER), _fnptr('Z3_fixed_eh')))
+    */
+    void Z3_API Z3_solver_propagate_fixed(Z3_context c, Z3_solver s, Z3_fixed_eh* fixed_eh);
+
+    /**
+       \brief register a callback on final check.
+       This provides freedom to the propagator to delay actions or implement a branch-and bound solver.
+       The final check is invoked when all decision variables have been assigned by the solver.
+
+       def_API('Z3_solver_propagate_final', VOID, (_in(CONTEXT), _in(SOLVER), _fnptr('Z3_final_eh')))
+    */
+    void Z3_API Z3_solver_propagate_final(Z3_context c, Z3_solver s, Z3_final_eh* final_eh);
+
+    /**
+       \brief register a callback on expression equalities.
+
+       def_API('Z3_solver_propagate_eq', VOID, (_in(CONTEXT), _in(SOLVER), _fnptr('Z3_eq_eh')))
+    */
+    void Z3_API Z3_solver_propagate_eq(Z3_context c, Z3_solver s, Z3_eq_eh* eq_eh);
+
+    /**
+       \brief register an expression to propagate on with the solver.
+       Fixed values are reported for Boolean expressions, equalities for expressions of any sort.
+       The identifier returned for the expression is used in callbacks.
+       Expressions should be registered before the first call to check.
+
+       def_API('Z3_solver_propagate_register', UINT, (_in(CONTEXT), _in(SOLVER), _in(AST)))
+    */
+    unsigned Z3_API Z3_solver_propagate_register(Z3_context c, Z3_solver s, Z3_ast e);
+
+    /**
+       \brief propagate a consequence based on fixed values and equalities.
+       This is a callback that can only be invoked from within a user propagator callback.
+       The consequence is justified by the current values of the expressions \c fixed_ids
+       and by the equalities \c eq_lhs[i] = \c eq_rhs[i].
+       If \c conseq is false, the justification is added as a conflict.
+
+       def_API('Z3_solver_propagate_consequence', VOID, (_in(CONTEXT), _in(SOLVER_CALLBACK), _in(UINT), _in_array(2, UINT), _in(UINT), _in_array(4, UINT), _in_array(4, UINT), _in(AST)))
+    */
+    void Z3_API Z3_solver_propagate_consequence(
+        Z3_context c, Z3_solver_callback cb,
+        unsigned num_fixed, unsigned const* fixed_ids,
+        unsigned num_eqs, unsigned const* eq_lhs, unsigned const* eq_rhs,
+        Z3_ast conseq);
+
     /**
        \brief Check whether the assertions in a given solver are consistent or not.
 
@@ -232,6 +232,70 @@ public:
 
 };
 
+eautomaton* eautomaton_cache::copy(sym_expr_manager& sm, eautomaton const& a) {
+    eautomaton::moves mvs;
+    for (unsigned s = 0; s < a.num_states(); ++s) {
+        for (eautomaton::move const& mv : a.get_moves_from(s)) {
+            mvs.push_back(eautomaton::move(sm, mv.src(), mv.dst(), mv.t()));
+        }
+    }
+    return alloc(eautomaton, sm, a.init(), a.final_states(), mvs);
+}
+
+eautomaton* eautomaton_cache::find(sym_expr_manager& sm, expr* re) {
+    entry* e = nullptr;
+    if (!m_cache.find(re, e)) {
+        ++m_stats.m_misses;
+        return nullptr;
+    }
+    ++m_stats.m_hits;
+    unlink(e);
+    push_front(e);
+    return copy(sm, *e->m_aut);
+}
+
+void eautomaton_cache::insert(expr* re, eautomaton const& a) {
+    if (m_max_size == 0 || m_cache.contains(re)) {
+        return;
+    }
+    while (m_cache.size() >= m_max_size) {
+        evict_lru();
+    }
+    m.inc_ref(re);
+    entry* e = alloc(entry);
+    e->m_re = re;
+    e->m_aut = copy(m_sm, a);
+    push_front(e);
+    m_cache.insert(re, e);
+}
+
+void eautomaton_cache::evict_lru() {
+    entry* e = m_lru.m_prev;
+    SASSERT(e != &m_lru);
+    unlink(e);
+    m_cache.erase(e->m_re);
+    dealloc(e->m_aut);
+    m.dec_ref(e->m_re);
+    dealloc(e);
+    ++m_stats.m_evictions;
+}
+
+void eautomaton_cache::reset() {
+    for (auto const& kv : m_cache) {
+        dealloc(kv.m_value->m_aut);
+        m.dec_ref(kv.m_key);
+        dealloc(kv.m_value);
+    }
+    m_cache.reset();
+    m_lru.m_prev = m_lru.m_next = &m_lru;
+}
+
+void eautomaton_cache::collect_statistics(statistics& st) const {
+    st.update("seq automata cache hits", m_stats.m_hits);
+    st.update("seq automata cache misses", m_stats.m_misses);
+    st.update("seq automata cache evictions", m_stats.m_evictions);
+}
+
 re2automaton::re2automaton(ast_manager& m): m(m), u(m), m_ba(nullptr), m_sa(nullptr) {}
 
 re2automaton::~re2automaton() {}
@@ -247,11 +311,17 @@ eautomaton* re2automaton::mk_product(eautomaton* a1, eautomaton* a2) {
 }
 
 eautomaton* re2automaton::operator()(expr* e) { 
-    eautomaton* r = re2aut(e); 
+    eautomaton* r = nullptr;
+    if (m_cache && (r = m_cache->find(sm, e))) {
+        return r;
+    }
+    r = re2aut(e); 
     if (r) {        
         r->compress(); 
-        bool_rewriter br(m);
         TRACE("seq", display_expr1 disp(m); r->display(tout << mk_pp(e, m) << " -->\n", disp););
+        if (m_cache) {
+            m_cache->insert(e, *r);
+        }
     }
     return r;
 } 
@@ -1626,6 +1696,12 @@ br_status seq_rewriter::mk_str_in_regexp(expr* a, expr* b, expr_ref& result) {
         result = m().mk_eq(a, b1);
         return BR_REWRITE1;
     }
+    zstring s;
+    bool is_member = false;
+    if (m_util.str.is_string(a, s) && in_re_by_derivatives(s, b, is_member)) {
+        result = m().mk_bool_val(is_member);
+        return BR_DONE;
+    }
     scoped_ptr<eautomaton> aut;
     expr_ref_vector seq(m());
     if (!(aut = m_re2aut(b))) {
@@ -2571,6 +2647,240 @@ bool seq_rewriter::is_epsilon(expr* e) const {
     return m_util.re.is_to_re(e, e1) && m_util.str.is_empty(e1);
 }
 
+/**
+   \brief check whether the regular expression r accepts the empty sequence.
+   Returns l_undef if r uses constructs whose nullability is not known syntactically.
+*/
+lbool seq_rewriter::is_nullable(expr* r) {
+    lbool result = l_undef;
+    if (m_nullable.find(r, result)) {
+        return result;
+    }
+    expr* r1 = nullptr, *r2 = nullptr, *s = nullptr;
+    unsigned lo = 0, hi = 0;
+    zstring str;
+    if (m_util.re.is_empty(r) || m_util.re.is_range(r) || m_util.re.is_full_char(r)) {
+        result = l_false;
+    }
+    else if (m_util.re.is_full_seq(r) || m_util.re.is_star(r) || m_util.re.is_opt(r)) {
+        result = l_true;
+    }
+    else if (m_util.re.is_to_re(r, s)) {
+        if (m_util.str.is_string(s, str)) {
+            result = str.empty() ? l_true : l_false;
+        }
+    }
+    else if (m_util.re.is_concat(r, r1, r2) || m_util.re.is_intersection(r, r1, r2)) {
+        lbool n1 = is_nullable(r1);
+        result = n1 == l_false ? l_false : (n1 == l_true ? is_nullable(r2) : l_undef);
+    }
+    else if (m_util.re.is_union(r, r1, r2)) {
+        lbool n1 = is_nullable(r1);
+        result = n1 == l_true ? l_true : (n1 == l_false ? is_nullable(r2) : l_undef);
+    }
+    else if (m_util.re.is_complement(r, r1)) {
+        result = ~is_nullable(r1);
+    }
+    else if (m_util.re.is_plus(r, r1)) {
+        result = is_nullable(r1);
+    }
+    else if (m_util.re.is_loop(r, r1, lo, hi)) {
+        // a loop with lo > hi denotes the empty language.
+        result = lo > hi ? l_false : lo == 0 ? l_true : is_nullable(r1);
+    }
+    else if (m_util.re.is_loop(r, r1, lo)) {
+        result = lo == 0 ? l_true : is_nullable(r1);
+    }
+    m_re_trail.push_back(r);
+    m_nullable.insert(r, result);
+    return result;
+}
+
+expr_ref seq_rewriter::mk_der_concat(expr* a, expr* b) {
+    if (m_util.re.is_empty(a) || is_epsilon(b)) return expr_ref(a, m());
+    if (m_util.re.is_empty(b) || is_epsilon(a)) return expr_ref(b, m());
+    return expr_ref(m_util.re.mk_concat(a, b), m());
+}
+
+expr_ref seq_rewriter::mk_der_union(expr* a, expr* b) {
+    if (a == b || m_util.re.is_empty(b) || m_util.re.is_full_seq(a)) return expr_ref(a, m());
+    if (m_util.re.is_empty(a) || m_util.re.is_full_seq(b)) return expr_ref(b, m());
+    // keep arguments ordered by id so that commuted unions share a derivative cache entry.
+    if (a->get_id() > b->get_id()) std::swap(a, b);
+    return expr_ref(m_util.re.mk_union(a, b), m());
+}
+
+expr_ref seq_rewriter::mk_der_inter(expr* a, expr* b) {
+    if (a == b || m_util.re.is_empty(a) || m_util.re.is_full_seq(b)) return expr_ref(a, m());
+    if (m_util.re.is_empty(b) || m_util.re.is_full_seq(a)) return expr_ref(b, m());
+    if (a->get_id() > b->get_id()) std::swap(a, b);
+    return expr_ref(m_util.re.mk_inter(a, b), m());
+}
+
+expr_ref seq_rewriter::mk_der_complement(expr* a) {
+    expr* a1 = nullptr;
+    if (m_util.re.is_complement(a, a1)) return expr_ref(a1, m());
+    if (m_util.re.is_empty(a)) return expr_ref(m_util.re.mk_full_seq(m().get_sort(a)), m());
+    if (m_util.re.is_full_seq(a)) return expr_ref(m_util.re.mk_empty(m().get_sort(a)), m());
+    return expr_ref(m_util.re.mk_complement(a), m());
+}
+
+/**
+   \brief Brzozowski derivative of r with respect to the character ch.
+   Returns nullptr if r contains constructs that are not handled.
+   Derivatives are hash-consed by the ast_manager and memoized per (r, ch),
+   so states of the implicit automaton are only created when they are reached.
+*/
+expr* seq_rewriter::mk_derivative(unsigned ch, expr* r) {
+    expr* result = nullptr;
+    if (m_derivatives.find(re_char(r, ch), result)) {
+        return result;
+    }
+    expr_ref d = mk_derivative_core(ch, r);
+    if (d) {
+        m_re_trail.push_back(r);
+        m_re_trail.push_back(d);
+        m_derivatives.insert(re_char(r, ch), d);
+    }
+    return d;
+}
+
+expr_ref seq_rewriter::mk_derivative_core(unsigned ch, expr* r) {
+    sort* seq_sort = nullptr;
+    VERIFY(m_util.is_re(r, seq_sort));
+    sort* re_sort = m().get_sort(r);
+    expr* r1 = nullptr, *r2 = nullptr, *s = nullptr;
+    expr* d1 = nullptr, *d2 = nullptr;
+    unsigned lo = 0, hi = 0;
+    zstring str, str2;
+    if (m_util.re.is_empty(r) || m_util.re.is_full_seq(r)) {
+        return expr_ref(r, m());
+    }
+    if (m_util.re.is_full_char(r)) {
+        return expr_ref(m_util.re.mk_to_re(m_util.str.mk_empty(seq_sort)), m());
+    }
+    if (m_util.re.is_to_re(r, s)) {
+        if (!m_util.str.is_string(s, str)) {
+            return expr_ref(m());
+        }
+        if (str.empty() || str[0] != ch) {
+            return expr_ref(m_util.re.mk_empty(re_sort), m());
+        }
+        return expr_ref(m_util.re.mk_to_re(m_util.str.mk_string(str.extract(1, str.length() - 1))), m());
+    }
+    if (m_util.re.is_range(r, r1, r2)) {
+        if (!m_util.str.is_string(r1, str) || !m_util.str.is_string(r2, str2) ||
+            str.length() != 1 || str2.length() != 1) {
+            return expr_ref(m());
+        }
+        if (str[0] <= ch && ch <= str2[0]) {
+            return expr_ref(m_util.re.mk_to_re(m_util.str.mk_empty(seq_sort)), m());
+        }
+        return expr_ref(m_util.re.mk_empty(re_sort), m());
+    }
+    if (m_util.re.is_concat(r, r1, r2)) {
+        lbool n1 = is_nullable(r1);
+        if (n1 == l_undef || !(d1 = mk_derivative(ch, r1))) {
+            return expr_ref(m());
+        }
+        if (n1 == l_false) {
+            return mk_der_concat(d1, r2);
+        }
+        if (!(d2 = mk_derivative(ch, r2))) {
+            return expr_ref(m());
+        }
+        expr_ref head = mk_der_concat(d1, r2);
+        return mk_der_union(head, d2);
+    }
+    if (m_util.re.is_union(r, r1, r2)) {
+        if (!(d1 = mk_derivative(ch, r1)) || !(d2 = mk_derivative(ch, r2))) {
+            return expr_ref(m());
+        }
+        return mk_der_union(d1, d2);
+    }
+    if (m_util.re.is_intersection(r, r1, r2)) {
+        if (!(d1 = mk_derivative(ch, r1)) || !(d2 = mk_derivative(ch, r2))) {
+            return expr_ref(m());
+        }
+        return mk_der_inter(d1, d2);
+    }
+    if (m_util.re.is_complement(r, r1)) {
+        if (!(d1 = mk_derivative(ch, r1))) {
+            return expr_ref(m());
+        }
+        return mk_der_complement(d1);
+    }
+    if (m_util.re.is_star(r, r1)) {
+        if (!(d1 = mk_derivative(ch, r1))) {
+            return expr_ref(m());
+        }
+        return mk_der_concat(d1, r);
+    }
+    if (m_util.re.is_plus(r, r1)) {
+        if (!(d1 = mk_derivative(ch, r1))) {
+            return expr_ref(m());
+        }
+        expr_ref star(m_util.re.mk_star(r1), m());
+        return mk_der_concat(d1, star);
+    }
+    if (m_util.re.is_opt(r, r1)) {
+        return expr_ref(mk_derivative(ch, r1), m());
+    }
+    if (m_util.re.is_loop(r, r1, lo, hi)) {
+        if (hi == 0 || lo > hi) {
+            return expr_ref(m_util.re.mk_empty(re_sort), m());
+        }
+        if (!(d1 = mk_derivative(ch, r1))) {
+            return expr_ref(m());
+        }
+        expr_ref loop(m_util.re.mk_loop(r1, lo == 0 ? 0 : lo - 1, hi - 1), m());
+        return mk_der_concat(d1, loop);
+    }
+    if (m_util.re.is_loop(r, r1, lo)) {
+        if (!(d1 = mk_derivative(ch, r1))) {
+            return expr_ref(m());
+        }
+        expr_ref loop(m_util.re.mk_loop(r1, lo == 0 ? 0 : lo - 1), m());
+        return mk_der_concat(d1, loop);
+    }
+    return expr_ref(m());
+}
+
+/**
+   \brief decide membership of the string literal s in r by repeated derivatives.
+   This avoids constructing an automaton for r; only the derivatives along s are built.
+   It only applies to ground memberships: theory_seq benefits when the string of a
+   membership rewrites to a literal, other memberships are propagated with automata.
+*/
+bool seq_rewriter::in_re_by_derivatives(zstring const& s, expr* r, bool& result) {
+    if (m_re_trail.size() > 100000) {
+        m_derivatives.reset();
+        m_nullable.reset();
+        m_re_trail.reset();
+    }
+    expr_ref d(r, m());
+    for (unsigned i = 0; i < s.length(); ++i) {
+        d = mk_derivative(s[i], d);
+        if (!d) {
+            return false;
+        }
+        if (m_util.re.is_empty(d)) {
+            result = false;
+            return true;
+        }
+        if (m_util.re.is_full_seq(d)) {
+            result = true;
+            return true;
+        }
+    }
+    lbool n = is_nullable(d);
+    if (n == l_undef) {
+        return false;
+    }
+    result = n == l_true;
+    return true;
+}
+
 bool seq_rewriter::is_subsequence(unsigned szl, expr* const* l, unsigned szr, expr* const* r, 
                                   expr_ref_vector& lhs, expr_ref_vector& rhs, bool& is_sat) {
     is_sat = true;
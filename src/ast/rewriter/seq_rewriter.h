@@ -24,6 +24,10 @@ Notes:
 #include "ast/rewriter/rewriter_types.h"
 #include "util/params.h"
 #include "util/lbool.h"
+#include "util/map.h"
+#include "util/obj_hashtable.h"
+#include "util/ref.h"
+#include "util/statistics.h"
 #include "math/automata/automaton.h"
 #include "math/automata/symbolic_automata.h"
 
@@ -78,6 +82,66 @@ public:
 };
 
 typedef automaton<sym_expr, sym_expr_manager> eautomaton;
+
+/**
+   \brief Cache of compressed automata for regular expressions.
+
+   Regular expressions are hash-consed, so the regex term is used as key.
+   Automata refer to terms of a single ast_manager, and the cache is
+   therefore shared only among re2automaton instances that use the same
+   manager. Entries are kept on a list in order of use; once more than
+   max_size automata are stored, the least recently used one is evicted.
+   Lookups return a private copy, so evictions never invalidate automata
+   handed out earlier.
+*/
+class eautomaton_cache {
+    struct entry {
+        expr*       m_re;
+        eautomaton* m_aut;
+        entry*      m_prev;
+        entry*      m_next;
+    };
+    struct stats {
+        unsigned m_hits;
+        unsigned m_misses;
+        unsigned m_evictions;
+        stats() { reset(); }
+        void reset() { memset(this, 0, sizeof(*this)); }
+    };
+    ast_manager&          m;
+    sym_expr_manager      m_sm;
+    unsigned              m_max_size;
+    unsigned              m_ref_count;
+    obj_map<expr, entry*> m_cache;
+    entry                 m_lru;        // sentinel, m_lru.m_next is the most recently used entry
+    stats                 m_stats;
+
+    void unlink(entry* e) { e->m_prev->m_next = e->m_next; e->m_next->m_prev = e->m_prev; }
+    void push_front(entry* e) { e->m_prev = &m_lru; e->m_next = m_lru.m_next; m_lru.m_next->m_prev = e; m_lru.m_next = e; }
+    void evict_lru();
+public:
+    eautomaton_cache(ast_manager& m, unsigned max_size):
+        m(m), m_max_size(max_size), m_ref_count(0) {
+        m_lru.m_re = nullptr;
+        m_lru.m_aut = nullptr;
+        m_lru.m_prev = m_lru.m_next = &m_lru;
+    }
+    ~eautomaton_cache() { reset(); }
+
+    void inc_ref() { ++m_ref_count; }
+    void dec_ref() { SASSERT(m_ref_count > 0); if (--m_ref_count == 0) dealloc(this); }
+
+    ast_manager& get_manager() const { return m; }
+    static eautomaton* copy(sym_expr_manager& sm, eautomaton const& a);
+
+    eautomaton* find(sym_expr_manager& sm, expr* re);
+    void insert(expr* re, eautomaton const& a);
+    void reset();
+    unsigned size() const { return m_cache.size(); }
+    void set_max_size(unsigned max_size) { m_max_size = max_size; }
+    void collect_statistics(statistics& st) const;
+};
+
 class re2automaton {
     typedef boolean_algebra<sym_expr*> boolean_algebra_t;
     typedef symbolic_automata<sym_expr, sym_expr_manager> symbolic_automata_t;
@@ -87,6 +151,7 @@ class re2automaton {
     scoped_ptr<expr_solver>         m_solver;
     scoped_ptr<boolean_algebra_t>   m_ba;
     scoped_ptr<symbolic_automata_t> m_sa;
+    ref<eautomaton_cache>           m_cache;
 
     eautomaton* re2aut(expr* e);
     eautomaton* seq2aut(expr* e);
@@ -96,6 +161,8 @@ public:
     eautomaton* operator()(expr* e);
     void set_solver(expr_solver* solver);
     bool has_solver() const { return m_solver; }
+    void set_cache(eautomaton_cache* c) { SASSERT(!c || &c->get_manager() == &m); m_cache = c; }
+    eautomaton_cache* get_cache() const { return m_cache.get(); }
     eautomaton* mk_product(eautomaton *a1, eautomaton *a2);
 };
 
@@ -108,6 +175,18 @@ class seq_rewriter {
     re2automaton   m_re2aut;
     expr_ref_vector m_es, m_lhs, m_rhs;
 
+    // memoized derivatives of regular expressions with respect to a character.
+    // Keys and values are pinned by m_re_trail, so the caches survive across
+    // rewrites and are shared by all queries that use this rewriter.
+    // They are only used to rewrite ground memberships (str.in.re s r with s
+    // a string literal); theory_seq still handles memberships of non-ground
+    // strings with automata.
+    typedef std::pair<expr*, unsigned> re_char;
+    typedef map<re_char, expr*, pair_hash<obj_ptr_hash<expr>, unsigned_hash>, default_eq<re_char> > derivative_map;
+    derivative_map   m_derivatives;
+    obj_map<expr, lbool> m_nullable;
+    expr_ref_vector  m_re_trail;
+
     br_status mk_seq_unit(expr* e, expr_ref& result);
     br_status mk_seq_concat(expr* a, expr* b, expr_ref& result);
     br_status mk_seq_length(expr* a, expr_ref& result);
@@ -158,13 +237,21 @@ class seq_rewriter {
     bool is_sequence(expr* e, expr_ref_vector& seq);
     bool is_sequence(eautomaton& aut, expr_ref_vector& seq);
     bool is_epsilon(expr* e) const;
+    lbool is_nullable(expr* r);
+    expr* mk_derivative(unsigned ch, expr* r);
+    expr_ref mk_derivative_core(unsigned ch, expr* r);
+    expr_ref mk_der_concat(expr* a, expr* b);
+    expr_ref mk_der_union(expr* a, expr* b);
+    expr_ref mk_der_inter(expr* a, expr* b);
+    expr_ref mk_der_complement(expr* a);
+    bool in_re_by_derivatives(zstring const& s, expr* r, bool& result);
     void split_units(expr_ref_vector& lhs, expr_ref_vector& rhs);
     bool get_lengths(expr* e, expr_ref_vector& lens, rational& pos);
 
 
 public:    
     seq_rewriter(ast_manager & m, params_ref const & p = params_ref()):
-        m_util(m), m_autil(m), m_re2aut(m), m_es(m), m_lhs(m), m_rhs(m) {
+        m_util(m), m_autil(m), m_re2aut(m), m_es(m), m_lhs(m), m_rhs(m), m_re_trail(m) {
     }
     ast_manager & m() const { return m_util.get_manager(); }
     family_id get_fid() const { return m_util.get_family_id(); }
@@ -174,6 +261,7 @@ public:
 
     void set_solver(expr_solver* solver) { m_re2aut.set_solver(solver); }
     bool has_solver() { return m_re2aut.has_solver(); }
+    void set_automata_cache(eautomaton_cache* c) { m_re2aut.set_cache(c); }
 
 
     br_status mk_app_core(func_decl * f, unsigned num_args, expr * const * args, expr_ref & result);
@@ -34,6 +34,8 @@ Notes:
 #include "ast/ast_pp.h"
 #include "ast/ast_util.h"
 #include "ast/well_sorted.h"
+#include "util/gparams.h"
+#include <sstream>
 
 namespace {
 struct th_rewriter_cfg : public default_rewriter_cfg {
@@ -800,6 +802,36 @@ struct th_rewriter::imp : public rewriter_tpl<th_rewriter_cfg> {
 th_rewriter::th_rewriter(ast_manager & m, params_ref const & p):
     m_params(p) {
     m_imp = alloc(imp, m, p);
+    m_params_id = UINT_MAX;
+}
+
+/**
+   \brief The key of the parameters in the memo table.
+   The rewriter reads its parameters from m_params and the global
+   'rewriter' module, so both are part of the key. It is computed on
+   the first use of the memo after the parameters changed, because
+   formatting the parameters and reading the global module are not cheap.
+*/
+std::string th_rewriter::mk_params_key() const {
+    std::ostringstream strm;
+    m_params.display(strm);
+    strm << "|";
+    gparams::get_module("rewriter").display(strm);
+    return strm.str();
+}
+
+bool th_rewriter::use_memo() {
+    if (!m_memo || m_imp->m().proofs_enabled() || m_imp->cfg().m_subst != nullptr)
+        return false;
+    if (m_params_id == UINT_MAX)
+        m_params_id = m_memo->get_params_id(mk_params_key());
+    return true;
+}
+
+void th_rewriter::set_memo(th_rewriter_memo* memo) {
+    SASSERT(!memo || &memo->get_manager() == &m_imp->m());
+    m_memo = memo;
+    m_params_id = UINT_MAX;
 }
 
 ast_manager & th_rewriter::m() const {
@@ -809,6 +841,7 @@ ast_manager & th_rewriter::m() const {
 void th_rewriter::updt_params(params_ref const & p) {
     m_params = p;
     m_imp->cfg().updt_params(p);
+    m_params_id = UINT_MAX;
 }
 
 void th_rewriter::get_param_descrs(param_descrs & r) {
@@ -845,16 +878,26 @@ void th_rewriter::reset() {
 
 void th_rewriter::operator()(expr_ref & term) {
     expr_ref result(term.get_manager());
-    m_imp->operator()(term, result);
+    (*this)(term.get(), result);
     term = std::move(result);
 }
 
 void th_rewriter::operator()(expr * t, expr_ref & result) {
+    if (use_memo() && m_memo->find(m_params_id, t, result))
+        return;
     m_imp->operator()(t, result);
+    if (use_memo())
+        m_memo->insert(m_params_id, t, result);
 }
 
 void th_rewriter::operator()(expr * t, expr_ref & result, proof_ref & result_pr) {
+    if (use_memo() && m_memo->find(m_params_id, t, result)) {
+        result_pr = nullptr;
+        return;
+    }
     m_imp->operator()(t, result, result_pr);
+    if (use_memo())
+        m_memo->insert(m_params_id, t, result);
 }
 
 expr_ref th_rewriter::operator()(expr * n, unsigned num_bindings, expr * const * bindings) {
@@ -894,3 +937,75 @@ bool th_rewriter::reduce_quantifier(quantifier * old_q,
                                     proof_ref & result_pr) {
     return m_imp->cfg().reduce_quantifier(old_q, new_body, new_patterns, new_no_patterns, result, result_pr);
 }
+
+unsigned th_rewriter_memo::get_params_id(std::string const& params_key) {
+    for (unsigned i = 0; i < m_params_keys.size(); ++i)
+        if (m_params_keys[i] == params_key)
+            return i;
+    m_params_keys.push_back(params_key);
+    return m_params_keys.size() - 1;
+}
+
+bool th_rewriter_memo::find(unsigned params_id, expr* t, expr_ref& result) {
+    expr* r = nullptr;
+    if (m_memo.find(key(params_id, t), r)) {
+        m_stats.m_hits++;
+        result = r;
+        return true;
+    }
+    m_stats.m_misses++;
+    return false;
+}
+
+void th_rewriter_memo::insert(unsigned params_id, expr* t, expr* result) {
+    if (m_max_size == 0)
+        return;
+    key k(params_id, t);
+    if (m_memo.contains(k))
+        return;
+    if (m_memo.size() >= m_max_size)
+        evict();
+    m.inc_ref(t);
+    m.inc_ref(result);
+    m_memo.insert(k, result);
+}
+
+void th_rewriter_memo::evict() {
+    // Entries whose input is referenced only by this table can
+    // not be queried again unless the client rebuilds the term.
+    svector<key> dead;
+    for (auto const& kv : m_memo) {
+        expr* t = kv.m_key.second;
+        unsigned pinned = 1 + (kv.m_value == t ? 1 : 0);
+        if (t->get_ref_count() <= pinned)
+            dead.push_back(kv.m_key);
+    }
+    if (2 * dead.size() < m_memo.size()) {
+        m_stats.m_evictions += m_memo.size();
+        reset();
+        return;
+    }
+    for (key const& k : dead) {
+        expr* r = nullptr;
+        VERIFY(m_memo.find(k, r));
+        m_memo.remove(k);
+        m.dec_ref(k.second);
+        m.dec_ref(r);
+    }
+    m_stats.m_evictions += dead.size();
+}
+
+void th_rewriter_memo::reset() {
+    for (auto const& kv : m_memo) {
+        m.dec_ref(kv.m_key.second);
+        m.dec_ref(kv.m_value);
+    }
+    m_memo.reset();
+}
+
+void th_rewriter_memo::collect_statistics(statistics& st) const {
+    st.update("rewriter memo size", m_memo.size());
+    st.update("rewriter memo hits", m_stats.m_hits);
+    st.update("rewriter memo misses", m_stats.m_misses);
+    st.update("rewriter memo evictions", m_stats.m_evictions);
+}
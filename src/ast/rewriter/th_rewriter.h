@@ -22,15 +22,69 @@ Notes:
 #include "ast/ast.h"
 #include "ast/rewriter/rewriter_types.h"
 #include "util/params.h"
+#include "util/map.h"
+#include "util/ref.h"
+#include "util/vector.h"
+#include "util/statistics.h"
+#include <string>
 
 class expr_substitution;
 
 class expr_solver;
 
+/**
+   \brief Memo table of top-level th_rewriter results.
+
+   The table can be shared by several th_rewriter objects over the same
+   manager. Entries are keyed by the rewriter parameters and the input term. Both the term and its result are pinned.
+   When the table is full, entries whose key is no longer referenced
+   outside the table are evicted first. If that does not free enough
+   space, the table is cleared.
+*/
+class th_rewriter_memo {
+    typedef std::pair<unsigned, expr*> key;
+    typedef map<key, expr*, pair_hash<unsigned_hash, obj_ptr_hash<expr> >, default_eq<key> > memo_map;
+    struct stats {
+        unsigned m_hits;
+        unsigned m_misses;
+        unsigned m_evictions;
+        stats() { reset(); }
+        void reset() { memset(this, 0, sizeof(*this)); }
+    };
+    ast_manager&        m;
+    unsigned            m_max_size;
+    unsigned            m_ref_count;
+    memo_map            m_memo;
+    vector<std::string> m_params_keys;
+    stats               m_stats;
+
+    void evict();
+public:
+    th_rewriter_memo(ast_manager& m, unsigned max_size):
+        m(m), m_max_size(max_size), m_ref_count(0) {}
+    ~th_rewriter_memo() { reset(); }
+
+    void inc_ref() { ++m_ref_count; }
+    void dec_ref() { SASSERT(m_ref_count > 0); if (--m_ref_count == 0) dealloc(this); }
+
+    ast_manager& get_manager() const { return m; }
+    unsigned size() const { return m_memo.size(); }
+
+    unsigned get_params_id(std::string const& params_key);
+    bool find(unsigned params_id, expr* t, expr_ref& result);
+    void insert(unsigned params_id, expr* t, expr* result);
+    void reset();
+    void collect_statistics(statistics& st) const;
+};
+
 class th_rewriter {
     struct     imp;
     imp *      m_imp;
     params_ref m_params;
+    unsigned   m_params_id;             // id of the parameters in m_memo, UINT_MAX if not yet computed
+    ref<th_rewriter_memo> m_memo;
+    std::string mk_params_key() const;
+    bool use_memo();
 public:
     th_rewriter(ast_manager & m, params_ref const & p = params_ref());
     ~th_rewriter();
@@ -70,6 +124,19 @@ public:
 
     void set_solver(expr_solver* solver);
 
+    /**
+       \brief Share the memo table \c memo with this rewriter.
+       It is consulted by the top-level entry points when proofs are disabled
+       and no substitution is set. The caller is responsible for not sharing
+       a memo between rewriters that use different solvers.
+
+       The memo is only shared between the rewriters of its owner: each
+       simplify tactic owns one, and the API context owns one for Z3_simplify.
+       Two simplify tactics in the same strategy do not see each other's results.
+    */
+    void set_memo(th_rewriter_memo* memo);
+    th_rewriter_memo* get_memo() const { return m_memo.get(); }
+
 };
 
 #endif
@@ -277,7 +277,7 @@ void lar_core_solver::solve() {
     ++settings().stats().m_need_to_solve_inf;
     CASSERT("A_off", !m_r_solver.A_mult_x_is_off());
     lp_assert((!settings().use_tableau()) || r_basis_is_OK());
-    if (need_to_presolve_with_double_solver()) {
+    if (need_to_presolve_with_double_solver() && settings().presolve_with_double_solver_for_lar) {
         TRACE("lar_solver", tout << "presolving\n";);
         prefix_d();
         lar_solution_signature solution_signature;
@@ -112,6 +112,7 @@ struct statistics {
     unsigned m_cross_nested_forms;
     unsigned m_grobner_calls;
     unsigned m_grobner_conflicts;
+    unsigned m_grobner_reused;
     statistics() { reset(); }
     void reset() { memset(this, 0, sizeof(*this)); }
 };
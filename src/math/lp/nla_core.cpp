@@ -1462,8 +1462,22 @@ void core::run_grobner() {
         return;
     }
     lp_settings().stats().m_grobner_calls++;
-    configure_grobner();
-    m_pdd_grobner.saturate();
+    // The saturated basis of the previous call is kept if the rows, the fixed
+    // values and the variable order it was computed from are unchanged. Only
+    // the intervals used to detect conflicts need to be evaluated again.
+    vector<rational> sig;
+    mk_grobner_signature(sig);
+    bool reused = !sig.empty() && sig == m_grobner_signature;
+    if (reused) {
+        lp_settings().stats().m_grobner_reused++;
+    }
+    else {
+        m_grobner_signature.reset();
+        if (!configure_grobner())
+            return;
+        m_pdd_grobner.saturate();
+        m_grobner_signature.swap(sig);
+    }
     bool conflict = false;
     unsigned n = m_pdd_grobner.number_of_conflicts_to_report();
     SASSERT(n > 0);
@@ -1485,8 +1499,10 @@ void core::run_grobner() {
     }
 }
 
-void core::configure_grobner() {
+bool core::configure_grobner() {
     m_pdd_grobner.reset();
+    // the dependencies of the basis live as long as the basis, see val_of_fixed_var_with_deps
+    m_pdd_grobner.dep().reset();
     try {
         set_level2var_for_grobner();
         for (unsigned i : m_rows) {
@@ -1495,7 +1511,7 @@ void core::configure_grobner() {
     }
     catch (...) {
         IF_VERBOSE(2, verbose_stream() << "pdd throw\n");
-        return;
+        return false;
     }
 #if 0
     IF_VERBOSE(2, m_pdd_grobner.display(verbose_stream()));
@@ -1520,6 +1536,51 @@ void core::configure_grobner() {
     m_pdd_grobner.set(cfg);
     m_pdd_grobner.adjust_cfg();
     m_pdd_manager.set_max_num_nodes(10000); // or something proportional to the number of initial nodes.
+    return true;
+}
+
+/**
+   \brief Serialize the input of the Grobner basis computation: the variable
+   order, the rows of the cluster, and the fixed values that pdd_expr
+   substitutes together with the constraints that justify them.
+*/
+void core::mk_grobner_signature(vector<rational>& sig) const {
+    unsigned_vector l2v;
+    mk_level2var_for_grobner(l2v);
+    for (unsigned v : l2v) 
+        sig.push_back(rational(v));
+    const auto& matrix = m_lar_solver.A_r();
+    for (unsigned i : m_rows) {
+        const auto& row = matrix.m_rows[i];
+        sig.push_back(rational(i));
+        sig.push_back(rational(row.size()));
+        for (const auto& p : row) {
+            sig.push_back(p.coeff());
+            add_var_to_grobner_signature(p.var(), sig);
+            if (!is_monic_var(p.var())) {
+                sig.push_back(rational(0));
+                continue;
+            }
+            const monic& m = emons()[p.var()];
+            sig.push_back(rational(m.size()));
+            for (lpvar k : m.vars()) 
+                add_var_to_grobner_signature(k, sig);
+        }
+    }
+}
+
+void core::add_var_to_grobner_signature(lpvar j, vector<rational>& sig) const {
+    sig.push_back(rational(j));
+    if (!var_is_fixed(j)) {
+        sig.push_back(rational(0));
+        return;
+    }
+    unsigned lc, uc;
+    m_lar_solver.get_bound_constraint_witnesses_for_column(j, lc, uc);
+    sig.push_back(rational(1));
+    sig.push_back(rational(lc));
+    sig.push_back(rational(uc));
+    sig.push_back(m_lar_solver.column_lower_bound(j).x);
 }
 
 std::ostream& core::diagnose_pdd_miss(std::ostream& out) {
@@ -1605,8 +1666,11 @@ void core::add_var_and_its_factors_to_q_and_collect_new_rows(lpvar j, svector<lp
 const rational& core::val_of_fixed_var_with_deps(lpvar j, u_dependency*& dep) {
     unsigned lc, uc;
     m_lar_solver.get_bound_constraint_witnesses_for_column(j, lc, uc);
-    dep = m_intervals.mk_join(dep, m_intervals.mk_leaf(lc));
-    dep = m_intervals.mk_join(dep, m_intervals.mk_leaf(uc));
+    // allocated by the Grobner solver: the interval dependencies are reset by
+    // every Horner pass, while a saturated basis is reused across final checks.
+    u_dependency_manager& dm = m_pdd_grobner.dep();
+    dep = dm.mk_join(dep, dm.mk_leaf(lc));
+    dep = dm.mk_join(dep, dm.mk_leaf(uc));
     return m_lar_solver.column_lower_bound(j).x;
 }
 
@@ -1712,6 +1776,12 @@ void core::set_active_vars_weights(nex_creator& nc) {
 }
 
 void core::set_level2var_for_grobner() {
+    unsigned_vector l2v;
+    mk_level2var_for_grobner(l2v);
+    m_pdd_manager.reset(l2v);
+}
+
+void core::mk_level2var_for_grobner(unsigned_vector& l2v) const {
     unsigned n = m_lar_solver.column_count();
     unsigned_vector sorted_vars(n), weighted_vars(n);
     for (unsigned j = 0; j < n; j++) {
@@ -1734,11 +1804,9 @@ void core::set_level2var_for_grobner() {
                                                       unsigned wb = weighted_vars[b];
                                                       return wa < wb || (wa == wb && a < b); });
 
-    unsigned_vector l2v(n);
+    l2v.reset();
     for (unsigned j = 0; j < n; j++)
-        l2v[j] = sorted_vars[j];
-
-    m_pdd_manager.reset(l2v);
+        l2v.push_back(sorted_vars[j]);
 }
 
 unsigned core::get_var_weight(lpvar j) const {
@@ -94,6 +94,7 @@ private:
     svector<lpvar>           m_add_buffer;
     mutable lp::u_set      m_active_var_set;
     lp::u_set              m_rows;
+    vector<rational>       m_grobner_signature; // input of the last Grobner basis computation
 public:
     reslimit                 m_reslim;
 
@@ -410,8 +411,11 @@ public:
     bool check_pdd_eq(const dd::solver::equation*);
     const rational& val_of_fixed_var_with_deps(lpvar j, u_dependency*& dep);
     dd::pdd pdd_expr(const rational& c, lpvar j, u_dependency*&);
+    void mk_level2var_for_grobner(unsigned_vector& l2v) const;
     void set_level2var_for_grobner();
-    void configure_grobner();
+    bool configure_grobner();
+    void mk_grobner_signature(vector<rational>& sig) const;
+    void add_var_to_grobner_signature(lpvar j, vector<rational>& sig) const;
     bool influences_nl_var(lpvar) const;
     bool is_nl_var(lpvar) const;
     bool is_used_in_monic(lpvar) const;
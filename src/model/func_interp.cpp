@@ -76,7 +76,8 @@ func_interp::func_interp(ast_manager & m, unsigned arity):
     m_else(nullptr),
     m_args_are_values(true),
     m_interp(nullptr),
-    m_array_interp(nullptr) {
+    m_array_interp(nullptr),
+    m_index(nullptr) {
 }
 
 func_interp::~func_interp() {
@@ -86,6 +87,7 @@ func_interp::~func_interp() {
     m_manager.dec_ref(m_else);
     m_manager.dec_ref(m_interp);
     m_manager.dec_ref(m_array_interp);
+    dealloc(m_index);
 }
 
 func_interp * func_interp::copy() const {
@@ -105,6 +107,34 @@ void func_interp::reset_interp_cache() {
     m_array_interp = nullptr;
 }
 
+void func_interp::reset_index() {
+    dealloc(m_index);
+    m_index = nullptr;
+}
+
+bool func_interp::args_are_unique_values(expr * const * args) const {
+    for (unsigned i = 0; i < m_arity; i++)
+        if (!m_manager.is_unique_value(args[i]))
+            return false;
+    return true;
+}
+
+/**
+   \brief index the entries whose arguments are unique values.
+   The first entry for a tuple of arguments is the one that is kept,
+   matching the order used by the linear search in get_entry.
+   The index is built by the mutators (insert_new_entry, compress) as soon
+   as there are more than s_index_threshold entries, so that get_entry
+   stays a read-only operation and can be called concurrently.
+*/
+void func_interp::init_index() {
+    SASSERT(!m_index);
+    m_index = alloc(entry_index, args_hash(m_arity), args_eq(m_arity));
+    for (func_entry * curr : m_entries)
+        if (args_are_unique_values(curr->get_args()))
+            m_index->insert_if_not_there(curr->get_args(), curr);
+}
+
 bool func_interp::is_fi_entry_expr(expr * e, ptr_vector<expr> & args) {
     args.reset();
     expr* c, *t, *f, *a0, *a1;
@@ -176,6 +206,11 @@ bool func_interp::is_constant() const {
    args_are_values to true if for all entries e e.args_are_values() is true.
 */
 func_entry * func_interp::get_entry(expr * const * args) const {
+    if (m_index && args_are_unique_values(args)) {
+        func_entry * entry = nullptr;
+        m_index->find(args, entry);
+        return entry;
+    }
     for (func_entry* curr : m_entries) {
         if (curr->eq_args(m(), m_arity, args))
             return curr;
@@ -213,6 +248,13 @@ void func_interp::insert_new_entry(expr * const * args, expr * r) {
     if (!new_entry->args_are_values())
         m_args_are_values = false;
     m_entries.push_back(new_entry);
+    if (m_index) {
+        if (args_are_unique_values(new_entry->get_args()))
+            m_index->insert_if_not_there(new_entry->get_args(), new_entry);
+    }
+    else if (m_arity > 0 && m_entries.size() > s_index_threshold) {
+        init_index();
+    }
 }
 
 bool func_interp::eval_else(expr * const * args, expr_ref & result) const {
@@ -269,7 +311,10 @@ void func_interp::compress() {
     }
     if (j < m_entries.size()) {
         reset_interp_cache();
+        reset_index();
         m_entries.shrink(j);
+        if (m_arity > 0 && m_entries.size() > s_index_threshold)
+            init_index();
     }
     // other compression, if else is a default branch.
     // or function encode identity.
@@ -280,6 +325,7 @@ void func_interp::compress() {
         }
         m_entries.reset();
         reset_interp_cache();
+        reset_index();
         m_manager.inc_ref(new_else);
         m_manager.dec_ref(m_else);
         m_else = new_else;
@@ -290,6 +336,7 @@ void func_interp::compress() {
         }
         m_entries.reset();
         reset_interp_cache();
+        reset_index();
         expr_ref new_else(m_manager.mk_var(0, m_manager.get_sort(m_else)), m_manager);
         m_manager.inc_ref(new_else);
         m_manager.dec_ref(m_else);
@@ -30,6 +30,7 @@ Revision History:
 #ifndef FUNC_INTERP_H_
 #define FUNC_INTERP_H_
 
+#include "util/map.h"
 #include "ast/ast.h"
 #include "ast/ast_translation.h"
 
@@ -65,6 +66,36 @@ public:
 };
 
 class func_interp {
+    /**
+       \brief index from argument tuples to entries.
+       Only entries whose arguments are all unique values are indexed.
+       For such arguments m().are_equal coincides with pointer equality,
+       so the index keys point directly into the arguments of the entries.
+    */
+    struct args_hash {
+        unsigned m_arity;
+        args_hash(unsigned arity): m_arity(arity) {}
+        unsigned operator()(expr * const * args) const {
+            return get_composite_hash(args, m_arity, default_kind_hash_proc<expr * const *>(), *this);
+        }
+        unsigned operator()(expr * const * args, unsigned idx) const { return args[idx]->hash(); }
+    };
+
+    struct args_eq {
+        unsigned m_arity;
+        args_eq(unsigned arity): m_arity(arity) {}
+        bool operator()(expr * const * args1, expr * const * args2) const {
+            for (unsigned i = 0; i < m_arity; ++i)
+                if (args1[i] != args2[i])
+                    return false;
+            return true;
+        }
+    };
+
+    typedef map<expr * const *, func_entry *, args_hash, args_eq> entry_index;
+
+    static const unsigned  s_index_threshold = 16;
+
     ast_manager &          m_manager;
     unsigned               m_arity;
     ptr_vector<func_entry> m_entries;
@@ -75,8 +106,16 @@ class func_interp {
 
     expr *                 m_array_interp; // <! interp with lambda abstraction
 
+    entry_index *          m_index; //!< built once there are more than s_index_threshold entries.
+
     void reset_interp_cache();
 
+    void reset_index();
+
+    void init_index();
+
+    bool args_are_unique_values(expr * const * args) const;
+
     expr * get_interp_core() const;
 
     expr * get_array_interp_core(func_decl * f) const;
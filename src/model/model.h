@@ -105,6 +105,7 @@ public:
     bool is_false(expr_ref_vector const& ts);
     bool are_equal(expr* s, expr* t);
     void reset_eval_cache();
+    model_evaluator& get_evaluator() { return m_mev; }
     bool has_solver(); 
     void set_solver(expr_solver* solver);
 
@@ -679,6 +679,23 @@ expr_ref model_evaluator::operator()(expr * t) {
     return result;
 }
 
+void model_evaluator::eval_app(func_decl * f, unsigned num, expr * const * args, expr_ref & result) {
+    proof_ref pr(m());
+    br_status st = m_imp->cfg().reduce_app(f, num, args, result, pr);
+    if (st == BR_DONE)
+        return;
+    expr_ref t(m());
+    if (st == BR_FAILED)
+        t = m().mk_app(f, num, args);
+    else
+        t = result;
+    m_imp->operator()(t, result);
+}
+
+void model_evaluator::expand_stores(expr_ref & val) {
+    m_imp->expand_stores(val);
+}
+
 expr_ref_vector model_evaluator::operator()(expr_ref_vector const& ts) {
     expr_ref_vector rs(m());
     for (expr* t : ts) rs.push_back((*this)(t));
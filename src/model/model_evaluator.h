@@ -48,6 +48,18 @@ public:
     expr_ref operator()(expr* t);
     expr_ref_vector operator()(expr_ref_vector const& ts);
 
+    /**
+       \brief evaluate f applied to arguments that are already evaluated.
+       Only the top-level application is reduced unless the reduction
+       produces a term that requires further rewriting.
+    */
+    void eval_app(func_decl * f, unsigned num, expr * const * args, expr_ref & r);
+
+    /**
+       \brief post-process a result of evaluation, as operator() does.
+    */
+    void expand_stores(expr_ref & val);
+
     // exception safe
     bool eval(expr* t, expr_ref& r, bool model_completion = true);
     bool eval(expr_ref_vector const& ts, expr_ref& r, bool model_completion = true);
@@ -0,0 +1,171 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    model_program.cpp
+
+Abstract:
+
+    Evaluate a fixed set of terms in many models.
+
+--*/
+#include "util/region.h"
+#include "model/model_program.h"
+
+model_program::model_program(ast_manager& m):
+    m(m),
+    m_terms(m) {}
+
+void model_program::reset() {
+    m_terms.reset();
+    m_program.reset();
+    m_args.reset();
+    m_roots.reset();
+    m_slot.reset();
+}
+
+unsigned model_program::add(expr* t) {
+    m_terms.push_back(t);
+    compile(t);
+    m_roots.push_back(m_slot[t]);
+    return m_roots.size() - 1;
+}
+
+/**
+   Post-order traversal that emits one instruction per subterm
+   that has not been compiled before.
+*/
+void model_program::compile(expr* t) {
+    if (m_slot.contains(t))
+        return;
+    ptr_buffer<expr> todo;
+    todo.push_back(t);
+    while (!todo.empty()) {
+        expr* e = todo.back();
+        if (m_slot.contains(e)) {
+            todo.pop_back();
+            continue;
+        }
+        unsigned slot = m_program.size();
+        if (!is_app(e)) {
+            // variables are kept, quantifiers are evaluated as a whole.
+            m_program.push_back(instr(is_var(e) ? I_VALUE : I_OPAQUE, e, 0, 0));
+            m_slot.insert(e, slot);
+            todo.pop_back();
+            continue;
+        }
+        app* a = to_app(e);
+        if (m.is_value(a)) {
+            m_program.push_back(instr(I_VALUE, e, 0, 0));
+            m_slot.insert(e, slot);
+            todo.pop_back();
+            continue;
+        }
+        bool visited = true;
+        for (expr* arg : *a) {
+            if (!m_slot.contains(arg)) {
+                todo.push_back(arg);
+                visited = false;
+            }
+        }
+        if (!visited)
+            continue;
+        unsigned first = m_args.size();
+        for (expr* arg : *a)
+            m_args.push_back(m_slot[arg]);
+        m_program.push_back(instr(I_APP, e, first, a->get_num_args()));
+        m_slot.insert(e, slot);
+        todo.pop_back();
+    }
+}
+
+/**
+   Demand-driven evaluation from the roots. A slot is computed once
+   the slots it depends on are. The condition of an if-then-else is
+   computed first; when it reduces to true or false only the selected
+   branch is computed.
+*/
+void model_program::run(model& mdl, bool model_completion, expr_ref_vector& result) {
+    model::scoped_model_completion _scm(mdl, model_completion);
+    model_evaluator& ev = mdl.get_evaluator();
+    expr_ref_vector values(m);
+    values.resize(m_program.size());
+    uf_cache cache;
+    region r;
+    unsigned_vector todo;
+    ptr_buffer<expr> args;
+    expr_ref val(m);
+    for (unsigned i = m_roots.size(); i-- > 0; )
+        todo.push_back(m_roots[i]);
+    while (!todo.empty()) {
+        unsigned slot = todo.back();
+        if (values.get(slot)) {
+            todo.pop_back();
+            continue;
+        }
+        instr const& i = m_program[slot];
+        unsigned const* arg_slots = m_args.c_ptr() + i.m_first_arg;
+        if (i.m_kind == I_VALUE) {
+            values.set(slot, i.m_term);
+            todo.pop_back();
+            continue;
+        }
+        if (i.m_kind == I_OPAQUE) {
+            values.set(slot, ev(i.m_term));
+            todo.pop_back();
+            continue;
+        }
+        if (m.is_ite(i.m_term)) {
+            expr* c = values.get(arg_slots[0]);
+            if (!c) {
+                todo.push_back(arg_slots[0]);
+                continue;
+            }
+            if (m.is_true(c) || m.is_false(c)) {
+                unsigned branch = arg_slots[m.is_true(c) ? 1 : 2];
+                if (!values.get(branch))
+                    todo.push_back(branch);
+                else {
+                    values.set(slot, values.get(branch));
+                    todo.pop_back();
+                }
+                continue;
+            }
+        }
+        bool ready = true;
+        for (unsigned j = i.m_num_args; j-- > 0; ) {
+            if (!values.get(arg_slots[j])) {
+                todo.push_back(arg_slots[j]);
+                ready = false;
+            }
+        }
+        if (!ready)
+            continue;
+        todo.pop_back();
+        func_decl* f = to_app(i.m_term)->get_decl();
+        args.reset();
+        for (unsigned j = 0; j < i.m_num_args; ++j)
+            args.push_back(values.get(arg_slots[j]));
+        if (i.m_num_args == 0 || f->get_family_id() != null_family_id) {
+            ev.eval_app(f, args.size(), args.c_ptr(), val);
+            values.set(slot, val);
+            continue;
+        }
+        expr* v = nullptr;
+        if (!cache.find(uf_key(f, args.c_ptr()), v)) {
+            ev.eval_app(f, args.size(), args.c_ptr(), val);
+            v = val;
+            expr** key_args = static_cast<expr**>(r.allocate(sizeof(expr*) * args.size()));
+            std::copy(args.begin(), args.end(), key_args);
+            cache.insert(uf_key(f, key_args), v);
+        }
+        values.set(slot, v);
+    }
+    result.reset();
+    for (unsigned slot : m_roots) {
+        val = values.get(slot);
+        ev.expand_stores(val);
+        result.push_back(val);
+    }
+}
@@ -0,0 +1,119 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    model_program.h
+
+Abstract:
+
+    Evaluate a fixed set of terms in many models.
+
+    The terms are compiled once into a program over value slots,
+    one slot per distinct subterm, in topological order. Running
+    the program in a model reduces each application it needs
+    exactly once using the values of its argument slots. Slots
+    are computed on demand from the roots, so the branch of an
+    if-then-else that the condition does not select is skipped.
+
+Notes:
+
+    Subterms under binders are not compiled; they are handed
+    to the model evaluator as a whole.
+
+    Applications of uninterpreted functions are memoized per run
+    on the declaration and the argument values, without building
+    the application, so repeated lookups in the same function
+    interpretation are hash lookups.
+
+--*/
+#ifndef MODEL_PROGRAM_H_
+#define MODEL_PROGRAM_H_
+
+#include "util/map.h"
+#include "ast/ast.h"
+#include "model/model.h"
+
+class model_program {
+
+    enum instr_kind {
+        I_VALUE,            // value or free variable, copied as is
+        I_APP,              // application over slots
+        I_OPAQUE            // evaluated by the model evaluator as a whole
+    };
+
+    struct instr {
+        instr_kind m_kind;
+        expr*      m_term;
+        unsigned   m_first_arg;
+        unsigned   m_num_args;
+        instr(instr_kind k, expr* t, unsigned first, unsigned num):
+            m_kind(k), m_term(t), m_first_arg(first), m_num_args(num) {}
+    };
+
+    /**
+       \brief application of an uninterpreted function to argument values.
+       The values are pinned by the slots of the run that creates the key.
+    */
+    struct uf_key {
+        func_decl*   m_decl;
+        expr* const* m_args;
+        uf_key(): m_decl(nullptr), m_args(nullptr) {}
+        uf_key(func_decl* f, expr* const* args): m_decl(f), m_args(args) {}
+    };
+
+    struct uf_key_hash {
+        unsigned operator()(uf_key const& k) const {
+            return combine_hash(k.m_decl->hash(),
+                                get_composite_hash(k, k.m_decl->get_arity(), default_kind_hash_proc<uf_key const&>(), *this));
+        }
+        unsigned operator()(uf_key const& k, unsigned idx) const { return k.m_args[idx]->hash(); }
+    };
+
+    struct uf_key_eq {
+        bool operator()(uf_key const& k1, uf_key const& k2) const {
+            if (k1.m_decl != k2.m_decl)
+                return false;
+            for (unsigned i = 0; i < k1.m_decl->get_arity(); ++i)
+                if (k1.m_args[i] != k2.m_args[i])
+                    return false;
+            return true;
+        }
+    };
+
+    typedef map<uf_key, expr*, uf_key_hash, uf_key_eq> uf_cache;
+
+    ast_manager&       m;
+    expr_ref_vector    m_terms;
+    svector<instr>     m_program;
+    unsigned_vector    m_args;
+    unsigned_vector    m_roots;
+    obj_map<expr, unsigned> m_slot;
+
+    void compile(expr* t);
+
+public:
+    model_program(ast_manager& m);
+
+    /**
+       \brief add a term to be evaluated. Returns the index of its
+       value in the result of run.
+    */
+    unsigned add(expr* t);
+
+    void add(expr_ref_vector const& ts) { for (expr* t : ts) add(t); }
+
+    unsigned size() const { return m_roots.size(); }
+
+    unsigned num_instructions() const { return m_program.size(); }
+
+    /**
+       \brief evaluate the added terms in mdl.
+       Results are stored in result in the order terms were added.
+    */
+    void run(model& mdl, bool model_completion, expr_ref_vector& result);
+
+    void reset();
+};
+
+#endif
@@ -0,0 +1,615 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    dl_sorted_table.cpp
+
+Abstract:
+
+    Table stored as a sorted run of fixed width rows.
+
+--*/
+
+#include <algorithm>
+#include "util/bit_vector.h"
+#include "util/hash.h"
+#include "muz/base/dl_util.h"
+#include "muz/rel/dl_sorted_table.h"
+
+namespace datalog {
+
+    // -----------------------------------
+    //
+    // sorted_table
+    //
+    // -----------------------------------
+
+    sorted_table::sorted_table(sorted_table_plugin & plugin, const table_signature & sig)
+        : table_base(plugin, sig),
+          m_arity(sig.size()),
+          m_sorted(0) {
+        SASSERT(m_arity > 0);
+    }
+
+    int sorted_table::compare(table_element const * r1, table_element const * r2) const {
+        for (unsigned i = 0; i < m_arity; ++i) {
+            if (r1[i] != r2[i]) {
+                return r1[i] < r2[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    /**
+       \brief least significant digit radix sort of n rows of the given
+       arity. Rows are moved as a whole, one pass per byte that is used
+       by the values of a column.
+    */
+    static void radix_sort_rows(table_element * rows, unsigned n, unsigned arity) {
+        if (n < 2) {
+            return;
+        }
+        size_t sz = static_cast<size_t>(n) * arity;
+        svector<table_element, size_t> buffer;
+        buffer.resize(sz);
+        table_element * src = rows;
+        table_element * dst = buffer.c_ptr();
+        unsigned counts[257];
+        for (unsigned c = arity; c-- > 0; ) {
+            table_element used = 0;
+            for (size_t i = c; i < sz; i += arity) {
+                used |= src[i];
+            }
+            for (unsigned shift = 0; shift < 64 && (used >> shift) != 0; shift += 8) {
+                std::fill(counts, counts + 257, 0);
+                for (size_t i = c; i < sz; i += arity) {
+                    counts[((src[i] >> shift) & 0xFF) + 1]++;
+                }
+                for (unsigned d = 0; d < 256; ++d) {
+                    counts[d + 1] += counts[d];
+                }
+                for (size_t i = 0; i < sz; i += arity) {
+                    size_t pos = static_cast<size_t>(counts[(src[i + c] >> shift) & 0xFF]++) * arity;
+                    std::copy(src + i, src + i + arity, dst + pos);
+                }
+                std::swap(src, dst);
+            }
+        }
+        if (src != rows) {
+            std::copy(src, src + sz, rows);
+        }
+    }
+
+    void sorted_table::normalize() const {
+        unsigned n = num_rows();
+        if (m_sorted == n) {
+            return;
+        }
+        table_element * base = m_rows.c_ptr();
+        radix_sort_rows(base + static_cast<size_t>(m_sorted) * m_arity, n - m_sorted, m_arity);
+
+        // merge the sorted run with the sorted tail, dropping duplicates.
+        row_storage result;
+        result.resize(m_rows.size());
+        table_element * out = result.c_ptr();
+        table_element const * last = nullptr;
+        auto push = [&](table_element const * r) {
+            if (last && compare(last, r) == 0) {
+                return;
+            }
+            std::copy(r, r + m_arity, out);
+            last = out;
+            out += m_arity;
+        };
+        unsigned i = 0, j = m_sorted;
+        while (i < m_sorted && j < n) {
+            table_element const * r1 = row(i);
+            table_element const * r2 = row(j);
+            if (compare(r1, r2) <= 0) {
+                push(r1);
+                ++i;
+            }
+            else {
+                push(r2);
+                ++j;
+            }
+        }
+        for (; i < m_sorted; ++i) {
+            push(row(i));
+        }
+        for (; j < n; ++j) {
+            push(row(j));
+        }
+        result.shrink(out - result.c_ptr());
+        m_rows.swap(result);
+        m_sorted = num_rows();
+    }
+
+    unsigned sorted_table::find(table_element const * f) const {
+        unsigned lo = 0, hi = m_sorted;
+        while (lo < hi) {
+            unsigned mid = lo + (hi - lo) / 2;
+            int c = compare(row(mid), f);
+            if (c == 0) {
+                return mid;
+            }
+            if (c < 0) {
+                lo = mid + 1;
+            }
+            else {
+                hi = mid;
+            }
+        }
+        return UINT_MAX;
+    }
+
+    unsigned sorted_table::hash_key(unsigned i, unsigned_vector const & cols) const {
+        table_element const * r = row(i);
+        unsigned h = 17;
+        for (unsigned c : cols) {
+            h = combine_hash(h, hash_ull(r[c]));
+        }
+        return hash_u(h);
+    }
+
+    table_base * sorted_table::clone() const {
+        sorted_table & res = sorted_table_plugin::get(*get_plugin().mk_empty(get_signature()));
+        res.m_rows = m_rows;
+        res.m_sorted = m_sorted;
+        return &res;
+    }
+
+    bool sorted_table::contains_fact(const table_fact & f) const {
+        normalize();
+        return find(f.c_ptr()) != UINT_MAX;
+    }
+
+    void sorted_table::remove_fact(const table_element * fact) {
+        remove_facts(1, fact);
+    }
+
+    void sorted_table::remove_facts(unsigned fact_cnt, const table_fact * facts) {
+        svector<table_element> flat;
+        for (unsigned i = 0; i < fact_cnt; ++i) {
+            flat.append(m_arity, facts[i].c_ptr());
+        }
+        remove_facts(fact_cnt, flat.c_ptr());
+    }
+
+    /**
+       Removed rows are marked first and the array is compacted once.
+    */
+    void sorted_table::remove_facts(unsigned fact_cnt, const table_element * facts) {
+        normalize();
+        bit_vector removed;
+        removed.resize(num_rows(), false);
+        bool found = false;
+        for (unsigned i = 0; i < fact_cnt; ++i) {
+            unsigned idx = find(facts + static_cast<size_t>(i) * m_arity);
+            if (idx != UINT_MAX) {
+                removed.set(idx);
+                found = true;
+            }
+        }
+        if (!found) {
+            return;
+        }
+        table_element * out = m_rows.c_ptr();
+        for (unsigned i = 0, n = num_rows(); i < n; ++i) {
+            if (removed.get(i)) {
+                continue;
+            }
+            table_element const * r = row(i);
+            if (r != out) {
+                std::copy(r, r + m_arity, out);
+            }
+            out += m_arity;
+        }
+        m_rows.shrink(out - m_rows.c_ptr());
+        m_sorted = num_rows();
+    }
+
+    class sorted_table::our_iterator_core : public iterator_core {
+        const sorted_table & m_parent;
+        unsigned             m_idx;
+
+        class our_row : public row_interface {
+            const our_iterator_core & m_iter;
+        public:
+            our_row(const our_iterator_core & iter) : row_interface(iter.m_parent), m_iter(iter) {}
+
+            void get_fact(table_fact & result) const override {
+                table_element const * r = m_iter.m_parent.row(m_iter.m_idx);
+                result.reset();
+                result.append(m_iter.m_parent.m_arity, r);
+            }
+            table_element operator[](unsigned col) const override {
+                return m_iter.m_parent.row(m_iter.m_idx)[col];
+            }
+        };
+
+        our_row m_row_obj;
+
+    public:
+        our_iterator_core(const sorted_table & t, bool finished) :
+            m_parent(t), m_idx(finished ? t.num_rows() : 0), m_row_obj(*this) {}
+
+        bool is_finished() const override {
+            return m_idx == m_parent.num_rows();
+        }
+
+        row_interface & operator*() override {
+            SASSERT(!is_finished());
+            return m_row_obj;
+        }
+        void operator++() override {
+            SASSERT(!is_finished());
+            ++m_idx;
+        }
+    };
+
+    table_base::iterator sorted_table::begin() const {
+        normalize();
+        return mk_iterator(alloc(our_iterator_core, *this, false));
+    }
+
+    table_base::iterator sorted_table::end() const {
+        normalize();
+        return mk_iterator(alloc(our_iterator_core, *this, true));
+    }
+
+    /**
+       \brief rows of a table grouped by the low bits of the hash of
+       their key columns.
+    */
+    struct sorted_table::partition {
+        unsigned_vector m_rows;     // row indices, grouped by partition
+        unsigned_vector m_hashes;   // key hash of the row at the same position
+        unsigned_vector m_start;    // m_start[k] is the first position of partition k
+
+        partition(sorted_table const & t, unsigned_vector const & cols, unsigned bits) {
+            unsigned n = t.num_rows();
+            unsigned num_parts = 1u << bits;
+            unsigned mask = num_parts - 1;
+            unsigned_vector hashes(n);
+            m_start.resize(num_parts + 1, 0);
+            for (unsigned i = 0; i < n; ++i) {
+                hashes[i] = t.hash_key(i, cols);
+                m_start[(hashes[i] & mask) + 1]++;
+            }
+            for (unsigned k = 0; k < num_parts; ++k) {
+                m_start[k + 1] += m_start[k];
+            }
+            unsigned_vector next(m_start);
+            m_rows.resize(n);
+            m_hashes.resize(n);
+            for (unsigned i = 0; i < n; ++i) {
+                unsigned pos = next[hashes[i] & mask]++;
+                m_rows[pos] = i;
+                m_hashes[pos] = hashes[i];
+            }
+        }
+    };
+
+    /**
+       \brief call emit(r1, r2) for every row r1 of t1 and r2 of t2 that
+       agree on cols1 and cols2.
+
+       Partitions of the smaller table are sized to stay in cache. The
+       hashes are compared before the key columns, so most mismatches
+       are rejected by a single comparison.
+    */
+    template<typename Emit>
+    void sorted_table::hash_join(sorted_table const & t1, sorted_table const & t2,
+                                 unsigned_vector const & cols1, unsigned_vector const & cols2, Emit & emit) {
+        unsigned n1 = t1.num_rows(), n2 = t2.num_rows();
+        if (n1 == 0 || n2 == 0) {
+            return;
+        }
+        if (cols1.empty()) {
+            for (unsigned i = 0; i < n1; ++i) {
+                for (unsigned j = 0; j < n2; ++j) {
+                    emit(t1.row(i), t2.row(j));
+                }
+            }
+            return;
+        }
+        bool swapped = n2 < n1;
+        sorted_table const & b = swapped ? t2 : t1;
+        sorted_table const & p = swapped ? t1 : t2;
+        unsigned_vector const & bcols = swapped ? cols2 : cols1;
+        unsigned_vector const & pcols = swapped ? cols1 : cols2;
+        unsigned key_cnt = bcols.size();
+
+        const unsigned rows_per_partition = 1024;
+        const unsigned max_bits = 12;
+        unsigned bits = 0;
+        while (bits < max_bits && (b.num_rows() >> bits) > rows_per_partition) {
+            ++bits;
+        }
+        partition bp(b, bcols, bits);
+        partition pp(p, pcols, bits);
+
+        unsigned_vector slots;
+        for (unsigned k = 0; k + 1 < bp.m_start.size(); ++k) {
+            unsigned bstart = bp.m_start[k], bend = bp.m_start[k + 1];
+            unsigned pstart = pp.m_start[k], pend = pp.m_start[k + 1];
+            if (bstart == bend || pstart == pend) {
+                continue;
+            }
+            unsigned size = 1;
+            while (size < 2 * (bend - bstart)) {
+                size *= 2;
+            }
+            unsigned mask = size - 1;
+            slots.reset();
+            slots.resize(size, UINT_MAX);
+            for (unsigned i = bstart; i < bend; ++i) {
+                unsigned s = (bp.m_hashes[i] >> bits) & mask;
+                while (slots[s] != UINT_MAX) {
+                    s = (s + 1) & mask;
+                }
+                slots[s] = i;
+            }
+            for (unsigned j = pstart; j < pend; ++j) {
+                unsigned h = pp.m_hashes[j];
+                table_element const * pr = p.row(pp.m_rows[j]);
+                for (unsigned s = (h >> bits) & mask; slots[s] != UINT_MAX; s = (s + 1) & mask) {
+                    unsigned i = slots[s];
+                    if (bp.m_hashes[i] != h) {
+                        continue;
+                    }
+                    table_element const * br = b.row(bp.m_rows[i]);
+                    unsigned c = 0;
+                    while (c < key_cnt && br[bcols[c]] == pr[pcols[c]]) {
+                        ++c;
+                    }
+                    if (c < key_cnt) {
+                        continue;
+                    }
+                    if (swapped) {
+                        emit(pr, br);
+                    }
+                    else {
+                        emit(br, pr);
+                    }
+                }
+            }
+        }
+    }
+
+    // -----------------------------------
+    //
+    // sorted_table_plugin
+    //
+    // -----------------------------------
+
+    table_base * sorted_table_plugin::mk_empty(const table_signature & s) {
+        SASSERT(can_handle_signature(s));
+        return alloc(sorted_table, *this, s);
+    }
+
+    sorted_table const & sorted_table_plugin::get(table_base const & t) {
+        return static_cast<sorted_table const &>(t);
+    }
+
+    sorted_table & sorted_table_plugin::get(table_base & t) {
+        return static_cast<sorted_table &>(t);
+    }
+
+    class sorted_table_plugin::join_fn : public convenient_table_join_fn {
+    public:
+        join_fn(const table_signature & t1_sig, const table_signature & t2_sig, unsigned col_cnt,
+                const unsigned * cols1, const unsigned * cols2)
+            : convenient_table_join_fn(t1_sig, t2_sig, col_cnt, cols1, cols2) {}
+
+        table_base * operator()(const table_base & tb1, const table_base & tb2) override {
+            sorted_table const & t1 = get(tb1);
+            sorted_table const & t2 = get(tb2);
+            t1.normalize();
+            t2.normalize();
+            sorted_table & res = get(*t1.get_plugin().mk_empty(get_result_signature()));
+            unsigned a1 = t1.m_arity, a2 = t2.m_arity;
+            auto emit = [&](table_element const * r1, table_element const * r2) {
+                res.m_rows.append(a1, r1);
+                res.m_rows.append(a2, r2);
+            };
+            sorted_table::hash_join(t1, t2, m_cols1, m_cols2, emit);
+            return &res;
+        }
+    };
+
+    table_join_fn * sorted_table_plugin::mk_join_fn(const table_base & t1, const table_base & t2,
+            unsigned col_cnt, const unsigned * cols1, const unsigned * cols2) {
+        if (!check_kind(t1) || !check_kind(t2)) {
+            return nullptr;
+        }
+        return alloc(join_fn, t1.get_signature(), t2.get_signature(), col_cnt, cols1, cols2);
+    }
+
+    class sorted_table_plugin::join_project_fn : public convenient_table_join_project_fn {
+        unsigned_vector m_out_cols;     // columns of the joined row that are kept
+    public:
+        join_project_fn(const table_signature & t1_sig, const table_signature & t2_sig, unsigned col_cnt,
+                        const unsigned * cols1, const unsigned * cols2, unsigned removed_col_cnt,
+                        const unsigned * removed_cols)
+            : convenient_table_join_project_fn(t1_sig, t2_sig, col_cnt, cols1, cols2,
+                                               removed_col_cnt, removed_cols) {
+            unsigned r = 0;
+            for (unsigned c = 0, sz = t1_sig.size() + t2_sig.size(); c < sz; ++c) {
+                if (r < removed_col_cnt && removed_cols[r] == c) {
+                    ++r;
+                    continue;
+                }
+                m_out_cols.push_back(c);
+            }
+        }
+
+        table_base * operator()(const table_base & tb1, const table_base & tb2) override {
+            sorted_table const & t1 = get(tb1);
+            sorted_table const & t2 = get(tb2);
+            t1.normalize();
+            t2.normalize();
+            sorted_table & res = get(*t1.get_plugin().mk_empty(get_result_signature()));
+            unsigned a1 = t1.m_arity;
+            auto emit = [&](table_element const * r1, table_element const * r2) {
+                for (unsigned c : m_out_cols) {
+                    res.m_rows.push_back(c < a1 ? r1[c] : r2[c - a1]);
+                }
+            };
+            sorted_table::hash_join(t1, t2, m_cols1, m_cols2, emit);
+            return &res;
+        }
+    };
+
+    table_join_fn * sorted_table_plugin::mk_join_project_fn(const table_base & t1, const table_base & t2,
+            unsigned col_cnt, const unsigned * cols1, const unsigned * cols2, unsigned removed_col_cnt,
+            const unsigned * removed_cols) {
+        if (!check_kind(t1) || !check_kind(t2) ||
+            removed_col_cnt == t1.get_signature().size() + t2.get_signature().size()) {
+            return nullptr;
+        }
+        return alloc(join_project_fn, t1.get_signature(), t2.get_signature(), col_cnt, cols1, cols2,
+                     removed_col_cnt, removed_cols);
+    }
+
+    class sorted_table_plugin::union_fn : public table_union_fn {
+    public:
+        void operator()(table_base & tgt0, const table_base & src0, table_base * delta0) override {
+            sorted_table & tgt = get(tgt0);
+            sorted_table const & src = get(src0);
+            sorted_table * delta = delta0 ? &get(*delta0) : nullptr;
+            if (&tgt == &src) {
+                return;
+            }
+            tgt.normalize();
+            src.normalize();
+            unsigned n1 = tgt.num_rows(), n2 = src.num_rows();
+            if (n2 == 0) {
+                return;
+            }
+
+            // few new rows: look them up and leave them to be merged on the next read.
+            if (n2 < n1 / 32) {
+                for (unsigned j = 0; j < n2; ++j) {
+                    table_element const * r = src.row(j);
+                    if (tgt.find(r) == UINT_MAX) {
+                        tgt.append(r);
+                        if (delta) delta->append(r);
+                    }
+                }
+                return;
+            }
+
+            sorted_table::row_storage result;
+            result.resize(tgt.m_rows.size() + src.m_rows.size());
+            table_element * out = result.c_ptr();
+            unsigned a = tgt.m_arity;
+            unsigned i = 0, j = 0;
+            while (i < n1 || j < n2) {
+                int c = i == n1 ? 1 : j == n2 ? -1 : tgt.compare(tgt.row(i), src.row(j));
+                table_element const * r;
+                if (c < 0) {
+                    r = tgt.row(i++);
+                }
+                else if (c > 0) {
+                    r = src.row(j++);
+                    if (delta) delta->append(r);
+                }
+                else {
+                    r = tgt.row(i++);
+                    ++j;
+                }
+                std::copy(r, r + a, out);
+                out += a;
+            }
+            result.shrink(out - result.c_ptr());
+            tgt.m_rows.swap(result);
+            tgt.m_sorted = tgt.num_rows();
+        }
+    };
+
+    table_union_fn * sorted_table_plugin::mk_union_fn(const table_base & tgt, const table_base & src,
+            const table_base * delta) {
+        if (!check_kind(tgt) || !check_kind(src) || (delta && !check_kind(*delta)) ||
+            tgt.get_signature() != src.get_signature() ||
+            (delta && delta->get_signature() != tgt.get_signature())) {
+            return nullptr;
+        }
+        return alloc(union_fn);
+    }
+
+    class sorted_table_plugin::project_fn : public convenient_table_project_fn {
+        unsigned_vector m_out_cols;
+    public:
+        project_fn(const table_signature & orig_sig, unsigned col_cnt, const unsigned * removed_cols)
+            : convenient_table_project_fn(orig_sig, col_cnt, removed_cols) {
+            unsigned r = 0;
+            for (unsigned c = 0; c < orig_sig.size(); ++c) {
+                if (r < col_cnt && removed_cols[r] == c) {
+                    ++r;
+                    continue;
+                }
+                m_out_cols.push_back(c);
+            }
+        }
+
+        table_base * operator()(const table_base & tb) override {
+            sorted_table const & t = get(tb);
+            sorted_table & res = get(*t.get_plugin().mk_empty(get_result_signature()));
+            for (unsigned i = 0, n = t.num_rows(); i < n; ++i) {
+                table_element const * r = t.row(i);
+                for (unsigned c : m_out_cols) {
+                    res.m_rows.push_back(r[c]);
+                }
+            }
+            return &res;
+        }
+    };
+
+    table_transformer_fn * sorted_table_plugin::mk_project_fn(const table_base & t, unsigned col_cnt,
+            const unsigned * removed_cols) {
+        if (!check_kind(t) || col_cnt == t.get_signature().size()) {
+            return nullptr;
+        }
+        return alloc(project_fn, t.get_signature(), col_cnt, removed_cols);
+    }
+
+    class sorted_table_plugin::rename_fn : public convenient_table_rename_fn {
+        unsigned_vector m_src_cols;     // column of the original row copied to each column
+    public:
+        rename_fn(const table_signature & orig_sig, unsigned permutation_cycle_len, const unsigned * permutation_cycle)
+            : convenient_table_rename_fn(orig_sig, permutation_cycle_len, permutation_cycle) {
+            for (unsigned i = 0; i < orig_sig.size(); ++i) {
+                m_src_cols.push_back(i);
+            }
+            permutate_by_cycle(m_src_cols, permutation_cycle_len, permutation_cycle);
+        }
+
+        table_base * operator()(const table_base & tb) override {
+            sorted_table const & t = get(tb);
+            sorted_table & res = get(*t.get_plugin().mk_empty(get_result_signature()));
+            unsigned a = t.m_arity;
+            res.m_rows.resize(t.m_rows.size());
+            table_element * out = res.m_rows.c_ptr();
+            // duplicates in the tail of t are dropped when the result is read.
+            for (unsigned i = 0, n = t.num_rows(); i < n; ++i, out += a) {
+                table_element const * r = t.row(i);
+                for (unsigned c = 0; c < a; ++c) {
+                    out[c] = r[m_src_cols[c]];
+                }
+            }
+            return &res;
+        }
+    };
+
+    table_transformer_fn * sorted_table_plugin::mk_rename_fn(const table_base & t, unsigned permutation_cycle_len,
+            const unsigned * permutation_cycle) {
+        if (!check_kind(t)) {
+            return nullptr;
+        }
+        return alloc(rename_fn, t.get_signature(), permutation_cycle_len, permutation_cycle);
+    }
+
+};
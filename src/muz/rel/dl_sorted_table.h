@@ -0,0 +1,142 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    dl_sorted_table.h
+
+Abstract:
+
+    Table stored as a sorted run of fixed width rows.
+
+    Rows are kept in one flat array of table elements. The prefix
+    of the array is sorted lexicographically and free of duplicates;
+    rows added since the last read are appended after it and merged
+    into the sorted run when the table is next inspected.
+
+    Joins are radix partitioned hash joins: the rows of both tables
+    are partitioned on the low bits of the hash of their key columns,
+    and each partition of the smaller table is indexed by a small
+    open addressing table that is probed by the matching partition
+    of the other table. Unions merge the sorted runs of both tables.
+
+Notes:
+
+    Signatures with functional columns are not supported.
+
+--*/
+
+#ifndef DL_SORTED_TABLE_H_
+#define DL_SORTED_TABLE_H_
+
+#include "util/vector.h"
+#include "muz/rel/dl_base.h"
+
+namespace datalog {
+
+    class sorted_table;
+
+    class sorted_table_plugin : public table_plugin {
+        friend class sorted_table;
+    protected:
+        class join_fn;
+        class join_project_fn;
+        class union_fn;
+        class project_fn;
+        class rename_fn;
+
+    public:
+        typedef sorted_table table;
+
+        sorted_table_plugin(relation_manager & manager)
+            : table_plugin(symbol("sorted"), manager) {}
+
+        bool can_handle_signature(const table_signature & s) override
+        { return !s.empty() && s.functional_columns() == 0; }
+
+        table_base * mk_empty(const table_signature & s) override;
+
+    protected:
+        table_join_fn * mk_join_fn(const table_base & t1, const table_base & t2,
+            unsigned col_cnt, const unsigned * cols1, const unsigned * cols2) override;
+        table_join_fn * mk_join_project_fn(const table_base & t1, const table_base & t2,
+            unsigned col_cnt, const unsigned * cols1, const unsigned * cols2, unsigned removed_col_cnt,
+            const unsigned * removed_cols) override;
+        table_union_fn * mk_union_fn(const table_base & tgt, const table_base & src,
+            const table_base * delta) override;
+        table_transformer_fn * mk_project_fn(const table_base & t, unsigned col_cnt,
+            const unsigned * removed_cols) override;
+        table_transformer_fn * mk_rename_fn(const table_base & t, unsigned permutation_cycle_len,
+            const unsigned * permutation_cycle) override;
+
+        static sorted_table const& get(table_base const&);
+        static sorted_table& get(table_base&);
+    };
+
+    class sorted_table : public table_base {
+        friend class sorted_table_plugin;
+        friend class sorted_table_plugin::join_fn;
+        friend class sorted_table_plugin::join_project_fn;
+        friend class sorted_table_plugin::union_fn;
+        friend class sorted_table_plugin::project_fn;
+        friend class sorted_table_plugin::rename_fn;
+
+        class our_iterator_core;
+        struct partition;
+
+        typedef svector<table_element, size_t> row_storage;
+
+        unsigned             m_arity;
+        mutable row_storage  m_rows;
+        mutable unsigned     m_sorted;      // number of rows in the sorted run
+
+        sorted_table(sorted_table_plugin & plugin, const table_signature & sig);
+
+        unsigned num_rows() const { return static_cast<unsigned>(m_rows.size() / m_arity); }
+        table_element const * row(unsigned i) const { return m_rows.c_ptr() + static_cast<size_t>(i) * m_arity; }
+        void append(table_element const * r) { m_rows.append(m_arity, r); }
+
+        int compare(table_element const * r1, table_element const * r2) const;
+
+        /**
+           \brief merge the appended rows into the sorted run.
+        */
+        void normalize() const;
+
+        /**
+           \brief index of \c f in the sorted run, or UINT_MAX.
+           Rows appended after the sorted run are not searched.
+        */
+        unsigned find(table_element const * f) const;
+
+        unsigned hash_key(unsigned i, unsigned_vector const & cols) const;
+
+        template<typename Emit>
+        static void hash_join(sorted_table const & t1, sorted_table const & t2,
+                              unsigned_vector const & cols1, unsigned_vector const & cols2, Emit & emit);
+
+    public:
+        sorted_table_plugin & get_plugin() const
+        { return static_cast<sorted_table_plugin &>(table_base::get_plugin()); }
+
+        table_base * clone() const override;
+        bool empty() const override { return m_rows.empty(); }
+        void reset() override { m_rows.reset(); m_sorted = 0; }
+
+        void add_fact(const table_fact & f) override { append(f.c_ptr()); }
+        void remove_fact(const table_element * fact) override;
+        void remove_facts(unsigned fact_cnt, const table_fact * facts) override;
+        void remove_facts(unsigned fact_cnt, const table_element * facts) override;
+        bool contains_fact(const table_fact & f) const override;
+
+        iterator begin() const override;
+        iterator end() const override;
+
+        unsigned get_size_estimate_rows() const override { normalize(); return num_rows(); }
+        unsigned get_size_estimate_bytes() const override { return static_cast<unsigned>(m_rows.size() * sizeof(table_element)); }
+        bool knows_exact_size() const override { return true; }
+    };
+
+};
+
+#endif /* DL_SORTED_TABLE_H_ */
@@ -768,6 +768,7 @@ void pred_transformer::collect_statistics(statistics& st) const
     st.update("SPACER num ctp blocked", m_stats.m_num_ctp_blocked);
     st.update("SPACER num is_invariant", m_stats.m_num_is_invariant);
     st.update("SPACER num lemma jumped", m_stats.m_num_lemma_level_jump);
+    st.update("SPACER num invariants promoted", m_stats.m_num_promoted);
 
     // -- time in rule initialization
     st.update ("time.spacer.init_rules.pt.init", m_initialize_watch.get_seconds ());
@@ -1232,6 +1233,9 @@ void pred_transformer::add_cover(unsigned level, expr* property, bool bg)
 void pred_transformer::propagate_to_infinity (unsigned level)
 {m_frames.propagate_to_infinity (level);}
 
+void pred_transformer::promote_invariants (unsigned level)
+{m_frames.promote_invariants (level);}
+
 // compute a conjunction of all background facts
 void pred_transformer::get_pred_bg_invs(expr_ref_vector& out) {
     expr_ref inv(m), tmp1(m), tmp2(m);
@@ -1537,6 +1541,32 @@ bool pred_transformer::is_invariant(unsigned level, lemma* lem,
     return r == l_false;
 }
 
+/// \brief true if \p lem is inductive relative to the infty frames:
+/// the infty lemmas of all predicates together with \p lem on the
+/// premises of this predicate imply \p lem on the conclusion.
+bool pred_transformer::is_relative_inductive(lemma* lem)
+{
+    if (lem->is_blocked() || !lem->is_ground()) return false;
+
+    m_stats.m_num_is_invariant++;
+    expr_ref_vector cand(m), aux(m), conj(m);
+    cand.push_back(mk_not(m, lem->get_expr()));
+    flatten_and (cand);
+
+    mk_assumptions(head(), lem->get_expr(), conj);
+    conj.push_back(m_extend_lit);
+    if (ctx.use_bg_invs()) get_pred_bg_invs(conj);
+
+    prop_solver::scoped_level _sl(*m_solver, infty_level());
+    prop_solver::scoped_subset_core _sc (*m_solver, true);
+    prop_solver::scoped_weakness _sw (*m_solver, 1,
+                                      ctx.weak_abs() ? lem->weakness() : UINT_MAX);
+    m_solver->set_core(nullptr);
+    m_solver->set_model(nullptr);
+    return l_false == m_solver->check_assumptions (cand, aux, m_transition_clause,
+                                                   conj.size(), conj.c_ptr(), 1);
+}
+
 bool pred_transformer::check_inductive(unsigned level, expr_ref_vector& state,
                                        unsigned& uses_level, unsigned weakness)
 {
@@ -2066,9 +2096,32 @@ void pred_transformer::frames::propagate_to_infinity (unsigned level)
             m_lemmas [i]->set_level (infty_level ());
             m_pt.add_lemma_core (m_lemmas [i]);
             m_sorted = false;
+            if (!m_lemmas[i]->external())
+                m_pt.get_context().new_lemma_eh(m_pt, m_lemmas[i]);
         }
 }
 
+/// Lemmas are usually moved to infty only once all frames converge.
+/// Checking them one by one makes the ones that are inductive relative
+/// to the infty frames available to the other contexts of a portfolio
+/// much earlier.
+void pred_transformer::frames::promote_invariants (unsigned level)
+{
+    for (unsigned i = 0, sz = m_lemmas.size (); i < sz; ++i) {
+        lemma *lem = m_lemmas.get(i);
+        if (lem->level() < level || is_infty_level(lem->level())) continue;
+
+        if (m_pt.is_relative_inductive(lem)) {
+            lem->set_level (infty_level ());
+            m_pt.add_lemma_core (lem);
+            m_sorted = false;
+            ++m_pt.m_stats.m_num_promoted;
+            if (!lem->external())
+                m_pt.get_context().new_lemma_eh(m_pt, lem);
+        }
+    }
+}
+
 void pred_transformer::frames::sort ()
 {
     if (m_sorted) { return; }
@@ -2095,6 +2148,8 @@ bool pred_transformer::frames::propagate_to_next_level (unsigned level)
         if (m_pt.is_invariant(tgt_level, m_lemmas.get(i), solver_level)) {
             m_lemmas [i]->set_level (solver_level);
             m_pt.add_lemma_core (m_lemmas.get(i));
+            if (is_infty_level(solver_level) && !m_lemmas[i]->external())
+                m_pt.get_context().new_lemma_eh(m_pt, m_lemmas.get(i));
 
             // percolate the lemma up to its new place
             for (unsigned j = i; (j+1) < sz && m_lt (m_lemmas[j+1], m_lemmas[j]); ++j) {
@@ -3637,6 +3692,14 @@ bool context::propagate(unsigned min_prop_lvl,
             return true;
         } else if (all_propagated && lvl > max_prop_lvl) { break; }
     }
+    // the contexts of a portfolio only exchange invariants
+    if (m_params.spacer_threads() > 1) {
+        for (auto & kv : m_rels) {
+            checkpoint();
+            kv.m_value->promote_invariants(min_prop_lvl);
+        }
+    }
+
     if (m_simplify_formulas_post) {
         simplify_formulas();
     }
@@ -4011,7 +4074,9 @@ void context::new_lemma_eh(pred_transformer &pt, lemma *lem) {
     }
     if (!handle)
         return;
-    if ((is_infty_level(lem->level()) && m_params.spacer_p3_share_invariants()) ||
+    // invariants are always shared between the contexts of a portfolio
+    bool share = m_params.spacer_threads() > 1;
+    if ((is_infty_level(lem->level()) && (share || m_params.spacer_p3_share_invariants())) ||
         (!is_infty_level(lem->level()) && m_params.spacer_p3_share_lemmas())) {
         expr_ref_vector args(m);
         for (unsigned i = 0; i < pt.sig_size(); ++i) {
@@ -212,6 +212,7 @@ class pred_transformer {
         unsigned m_num_is_invariant; // num of times lemmas are pushed
         unsigned m_num_lemma_level_jump; // lemma learned at higher level than expected
         unsigned m_num_reach_queries;
+        unsigned m_num_promoted; // num of lemmas moved to infty by promote_invariants
 
         stats() { reset(); }
         void reset() { memset(this, 0, sizeof(*this)); }
@@ -283,6 +284,7 @@ class pred_transformer {
         bool add_lemma (lemma *new_lemma);
         void propagate_to_infinity (unsigned level);
         bool propagate_to_next_level (unsigned level);
+        void promote_invariants (unsigned level);
     };
 
     /**
@@ -501,6 +503,9 @@ public:
 
     bool propagate_to_next_level(unsigned level);
     void propagate_to_infinity(unsigned level);
+    /// \brief Move to infty the lemmas at \p level or above that are
+    /// inductive relative to the infty frames
+    void promote_invariants(unsigned level);
     /// \brief  Add a lemma to the current context and all users
     bool add_lemma(expr * e, unsigned lvl, bool bg);
     bool add_lemma(lemma* lem) {return m_frames.add_lemma(lem);}
@@ -542,6 +547,8 @@ public:
         UNREACHABLE(); return false;
     }
 
+    bool is_relative_inductive(lemma* lem);
+
     bool check_inductive(unsigned level, expr_ref_vector& state,
                          unsigned& assumes_level, unsigned weakness = UINT_MAX);
 
@@ -35,6 +35,7 @@ Revision History:
 #include "ast/scoped_proof.h"
 #include "muz/transforms/dl_transforms.h"
 #include "muz/spacer/spacer_callback.h"
+#include "muz/spacer/spacer_portfolio.h"
 
 using namespace spacer;
 
@@ -164,7 +165,7 @@ lbool dl_interface::query(expr * query)
         return l_false;
     }
 
-    return m_context->solve(m_ctx.get_params().spacer_min_level());
+    return solve(query_pred, m_ctx.get_params().spacer_min_level());
 
 }
 
@@ -257,10 +258,20 @@ lbool dl_interface::query_from_lvl(expr * query, unsigned lvl)
         return l_false;
     }
 
-    return m_context->solve(lvl);
+    return solve(query_pred, lvl);
 
 }
 
+lbool dl_interface::solve(func_decl* query_pred, unsigned lvl)
+{
+    unsigned num_threads = m_ctx.get_params().spacer_threads();
+    if (num_threads <= 1) {
+        return m_context->solve(lvl);
+    }
+    portfolio p(*m_context, m_spacer_rules, query_pred, m_ctx.get_params_ref(), num_threads - 1);
+    return p.solve(lvl);
+}
+
 expr_ref dl_interface::get_cover_delta(int level, func_decl* pred_orig)
 {
     func_decl* pred = pred_orig;
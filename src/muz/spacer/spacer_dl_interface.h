@@ -43,6 +43,8 @@ class dl_interface : public datalog::engine_base {
 
     void check_reset();
 
+    lbool solve(func_decl* query_pred, unsigned lvl);
+
 public:
     dl_interface(datalog::context& ctx);
     ~dl_interface() override;
@@ -0,0 +1,197 @@
+/**++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    spacer_portfolio.cpp
+
+Abstract:
+
+    Run several SPACER contexts on the same rules in parallel.
+
+--*/
+
+#include <thread>
+#include "util/vector.h"
+#include "util/util.h"
+#include "ast/ast_translation.h"
+#include "smt/params/smt_params.h"
+#include "muz/base/dl_context.h"
+#include "muz/spacer/spacer_portfolio.h"
+
+namespace spacer {
+
+    lemma_store::lemma_store(ast_manager& m):
+        m_manager(alloc(ast_manager, m, true)),
+        m_lemmas(*m_manager) {}
+
+    void lemma_store::publish(unsigned source, ast_manager& m, expr_ref_vector const& lemmas) {
+        std::lock_guard<std::mutex> lock(m_mux);
+        ast_translation tr(m, *m_manager, false);
+        for (expr* e : lemmas) {
+            m_lemmas.push_back(tr(e));
+            m_sources.push_back(source);
+        }
+    }
+
+    void lemma_store::fetch(unsigned dest, ast_manager& m, unsigned& head, expr_ref_vector& lemmas) {
+        std::lock_guard<std::mutex> lock(m_mux);
+        if (head == m_lemmas.size())
+            return;
+        ast_translation tr(*m_manager, m, false);
+        for (; head < m_lemmas.size(); ++head) {
+            if (m_sources[head] != dest)
+                lemmas.push_back(tr(m_lemmas.get(head)));
+        }
+    }
+
+    void lemma_exchange::new_lemma_eh(expr* lemma, unsigned level) {
+        // lemmas that are imported again must not be sent back to the store.
+        if (m_importing || !is_infty_level(level))
+            return;
+        m_pending.push_back(lemma);
+    }
+
+    void lemma_exchange::flush() {
+        if (m_pending.empty())
+            return;
+        m_store.publish(m_id, m_context.get_ast_manager(), m_pending);
+        m_pending.reset();
+    }
+
+    void lemma_exchange::import() {
+        flush();
+        expr_ref_vector lemmas(m_context.get_ast_manager());
+        m_store.fetch(m_id, m_context.get_ast_manager(), m_head, lemmas);
+        flet<bool> _importing(m_importing, true);
+        for (expr* e : lemmas) {
+            m_context.add_constraint(e, infty_level());
+        }
+    }
+
+    /**
+       \brief a helper context together with the manager and the
+       datalog context that own its rules.
+    */
+    struct portfolio::helper : public datalog::register_engine_base {
+        scoped_ptr<ast_manager>         m_manager;
+        smt_params                      m_fparams;
+        scoped_ptr<datalog::context>    m_ctx;
+        scoped_ptr<datalog::rule_set>   m_rules;
+        scoped_ptr<context>             m_context;
+        func_decl*                      m_query;
+
+        helper(): m_query(nullptr) {}
+
+        // helpers never create datalog engines.
+        datalog::engine_base* mk_engine(datalog::DL_ENGINE) override { return nullptr; }
+        void set_context(datalog::context*) override {}
+    };
+
+    portfolio::portfolio(context& main, datalog::rule_set const& rules, func_decl* query_pred,
+                         params_ref const& p, unsigned num_helpers):
+        m_main(main),
+        m(main.get_ast_manager()),
+        m_store(m) {
+        for (unsigned i = 0; i < num_helpers; ++i) {
+            init_helper(i + 1, rules, query_pred, p);
+        }
+    }
+
+    portfolio::~portfolio() {}
+
+    /**
+       \brief translate the rules into a fresh manager. This runs on the
+       calling thread since it reads from the main manager.
+    */
+    void portfolio::init_helper(unsigned id, datalog::rule_set const& rules,
+                                func_decl* query_pred, params_ref const& p) {
+        helper* h = alloc(helper);
+        m_helpers.push_back(h);
+        h->m_manager = alloc(ast_manager, m, true);
+        ast_manager& hm = *h->m_manager;
+
+        params_ref hp(p);
+        hp.set_uint("spacer.random_seed", m_main.get_params().spacer_random_seed() + id);
+        hp.set_bool("validate", false);
+        h->m_ctx = alloc(datalog::context, hm, *h, h->m_fparams, hp);
+
+        ast_translation tr(m, hm, false);
+        datalog::rule_manager& rm = h->m_ctx->get_rule_manager();
+        for (datalog::rule* r : rules) {
+            h->m_ctx->register_predicate(tr(r->get_decl()), false);
+            for (unsigned i = 0; i < r->get_uninterpreted_tail_size(); ++i) {
+                h->m_ctx->register_predicate(tr(r->get_decl(i)), false);
+            }
+        }
+        h->m_query = tr(query_pred);
+        h->m_ctx->register_predicate(h->m_query, false);
+
+        h->m_rules = alloc(datalog::rule_set, *h->m_ctx);
+        app_ref head(hm);
+        app_ref_vector tail(hm);
+        svector<bool> is_neg;
+        for (datalog::rule* r : rules) {
+            head = tr(r->get_head());
+            tail.reset();
+            is_neg.reset();
+            for (unsigned i = 0; i < r->get_tail_size(); ++i) {
+                tail.push_back(tr(r->get_tail(i)));
+                is_neg.push_back(r->is_neg_tail(i));
+            }
+            h->m_rules->add_rule(rm.mk(head, tail.size(), tail.c_ptr(), is_neg.c_ptr(), r->name(), false));
+        }
+        h->m_rules->set_output_predicate(h->m_query);
+        h->m_rules->close();
+    }
+
+    lbool portfolio::solve(unsigned from_lvl) {
+        m_main.callbacks().push_back(alloc(lemma_exchange, m_main, m_store, 0));
+        scoped_limits sl(m.limit());
+        for (helper* h : m_helpers) {
+            sl.push_child(&h->m_manager->limit());
+        }
+
+        vector<std::thread> threads(m_helpers.size());
+        for (unsigned i = 0; i < m_helpers.size(); ++i) {
+            threads[i] = std::thread([&, i]() {
+                helper& h = *m_helpers[i];
+                try {
+                    h.m_context = alloc(context, h.m_ctx->get_params(), *h.m_manager);
+                    lemma_exchange* ex = alloc(lemma_exchange, *h.m_context, m_store, i + 1);
+                    h.m_context->callbacks().push_back(ex);
+                    h.m_context->set_query(h.m_query);
+                    h.m_context->update_rules(*h.m_rules);
+                    // a safe helper publishes its complete invariant.
+                    if (h.m_context->solve() == l_false)
+                        ex->flush();
+                }
+                catch (z3_exception &) {
+                    // helpers only contribute lemmas, the answer
+                    // comes from the main context.
+                }
+            });
+        }
+
+        auto stop = [&]() {
+            for (helper* h : m_helpers) {
+                h->m_manager->limit().cancel();
+            }
+            for (auto & th : threads) {
+                th.join();
+            }
+            m_main.callbacks().pop_back();
+        };
+
+        lbool r = l_undef;
+        try {
+            r = m_main.solve(from_lvl);
+        }
+        catch (...) {
+            stop();
+            throw;
+        }
+        stop();
+        return r;
+    }
+}
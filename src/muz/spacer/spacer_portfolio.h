@@ -0,0 +1,124 @@
+/**++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    spacer_portfolio.h
+
+Abstract:
+
+    Run several SPACER contexts on the same rules in parallel.
+
+    Each helper context has its own ast_manager and a different
+    random seed. Invariants learned by any of the contexts are
+    published to a shared lemma store, and every context imports
+    the invariants published by the others before expanding a
+    proof obligation and when it moves to a new level.
+
+    The main context is the one that runs on the calling thread.
+    It is the only one whose answer, model and certificate are
+    reported; the helpers are cancelled as soon as it finishes.
+
+Notes:
+
+    Only lemmas at the infinity level are exchanged. A lemma at
+    level k of one context need not be implied by the frame k-1
+    of another context and the transition relation, so importing
+    it could break the invariant that frames are relatively
+    inductive. The infinity level of a context is inductive
+    whenever the context is between two expansions; lemmas are
+    therefore buffered and published at those points only, so
+    any set of imported lemmas is inductive and can be asserted
+    at the infinity level of the importing context.
+
+    Besides the lemmas of converged frames, every context of a
+    portfolio checks after each propagation which of its frame
+    lemmas are inductive relative to its infinity level, and moves
+    those to the infinity level so that they are published too.
+
+--*/
+
+#ifndef _SPACER_PORTFOLIO_H_
+#define _SPACER_PORTFOLIO_H_
+
+#include <mutex>
+#include "util/lbool.h"
+#include "util/scoped_ptr_vector.h"
+#include "muz/base/dl_rule_set.h"
+#include "muz/spacer/spacer_context.h"
+
+namespace spacer {
+
+    /**
+       \brief lock protected store of the invariants shared between contexts.
+       Lemmas are kept in the store's own ast_manager and translated on
+       publication and on import.
+    */
+    class lemma_store {
+        std::mutex                m_mux;
+        scoped_ptr<ast_manager>   m_manager;
+        expr_ref_vector           m_lemmas;
+        unsigned_vector           m_sources;
+    public:
+        lemma_store(ast_manager& m);
+
+        void publish(unsigned source, ast_manager& m, expr_ref_vector const& lemmas);
+
+        /**
+           \brief import the lemmas published by other contexts after position head
+           into m. head is advanced to the end of the store.
+        */
+        void fetch(unsigned dest, ast_manager& m, unsigned& head, expr_ref_vector& lemmas);
+    };
+
+    /**
+       \brief callback that connects a context to a lemma store.
+    */
+    class lemma_exchange : public spacer_callback {
+        lemma_store&    m_store;
+        unsigned        m_id;
+        unsigned        m_head;
+        bool            m_importing;
+        expr_ref_vector m_pending;
+        void import();
+    public:
+        lemma_exchange(context& ctx, lemma_store& store, unsigned id):
+            spacer_callback(ctx), m_store(store), m_id(id), m_head(0), m_importing(false),
+            m_pending(ctx.get_ast_manager()) {}
+
+        /**
+           \brief publish the invariants learned since the last call.
+        */
+        void flush();
+
+        bool new_lemma() override { return true; }
+        void new_lemma_eh(expr* lemma, unsigned level) override;
+
+        bool predecessor() override { return true; }
+        void predecessor_eh() override { import(); }
+
+        bool unfold() override { return true; }
+        void unfold_eh() override { import(); }
+    };
+
+    class portfolio {
+        struct helper;
+
+        context&                    m_main;
+        ast_manager&                m;
+        lemma_store                 m_store;
+        scoped_ptr_vector<helper>   m_helpers;
+
+        void init_helper(unsigned id, datalog::rule_set const& rules,
+                         func_decl* query_pred, params_ref const& p);
+
+    public:
+        portfolio(context& main, datalog::rule_set const& rules, func_decl* query_pred,
+                  params_ref const& p, unsigned num_helpers);
+        ~portfolio();
+
+        lbool solve(unsigned from_lvl);
+    };
+}
+
+#endif
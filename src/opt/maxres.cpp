@@ -44,6 +44,14 @@ Abstract:
        If there are no satisfying assignments to F, then the current best assignment
        is the optimum.
 
+    With maxres.incremental_totalizer, cores are relaxed OLL style:
+    a core b1, ..., bn is replaced by a totalizer whose outputs o_k
+    hold if at least k of the b_i are false. The soft constraint !o_2
+    replaces the core. When a later core or correction set contains !o_k,
+    the totalizer is extended by one output and !o_{k+1} becomes soft. Outputs are
+    built lazily, so an encoding only grows to the bound that cores
+    actually reach.
+
 Author:
 
     Nikolaj Bjorner (nbjorner) 2014-20-7
@@ -107,6 +115,15 @@ private:
                                                // this option is disabled if SAT core is used.
     bool             m_pivot_on_cs;            // prefer smaller correction set to core.
     bool             m_dump_benchmarks;        // display benchmarks (into wcnf format)
+    bool             m_incremental_totalizer;  // relax cores using incremental totalizers (OLL)
+
+    struct tot_node {
+        unsigned         m_left, m_right;  // children, UINT_MAX for leaves
+        unsigned         m_size;           // number of inputs below the node
+        ptr_vector<expr> m_out;            // m_out[k-1] holds if at least k inputs are true
+    };
+    vector<tot_node> m_tot;
+    obj_map<expr, std::pair<unsigned, unsigned>> m_tot_asm; // !o_k |-> (root, k)
 
     
 
@@ -133,7 +150,8 @@ public:
         m_max_core_size(3),
         m_maximize_assignment(false),
         m_max_correction_set_size(3),
-        m_pivot_on_cs(true)       
+        m_pivot_on_cs(true),
+        m_incremental_totalizer(false)
     {
         switch(st) {
         case s_primal:
@@ -469,6 +487,8 @@ public:
         TRACE("opt", display_vec(tout << "corr_set: ", corr_set););
         remove_soft(corr_set, m_asms);
         rational w = split_core(corr_set);
+        if (m_incremental_totalizer)
+            tot_relax(corr_set, w);
         cs_max_resolve(corr_set, w);       
         IF_VERBOSE(2, verbose_stream() << "(opt.maxres.correction-set " << corr_set.size() << ")\n";);
         m_csmodel = nullptr;
@@ -517,7 +537,10 @@ public:
         SASSERT(!core.empty());
         TRACE("opt", display_vec(tout << "minimized core: ", core););
         IF_VERBOSE(10, display_vec(verbose_stream() << "core: ", core););        
-        max_resolve(core, w);
+        if (m_incremental_totalizer) 
+            totalizer_resolve(core, w);
+        else
+            max_resolve(core, w);
         fml = mk_not(m, mk_and(m, core.size(), core.c_ptr()));
         add(fml);
         // save small cores such that lex-combinations of maxres can reuse these cores.
@@ -678,6 +701,108 @@ public:
         }
     }
 
+    //
+    // Relax the core using totalizers:
+    // - each !o_k in the core is replaced by !o_{k+1} of the same totalizer,
+    // - the core itself is replaced by !o_2 of a fresh totalizer over
+    //   the negated core literals; o_1 is implied by the core.
+    // 
+    void totalizer_resolve(exprs const& core, rational const& w) {
+        SASSERT(!core.empty());
+        tot_relax(core, w);
+        if (core.size() > 1) {
+            unsigned root = mk_totalizer(core, 0, core.size());
+            tot_extend(root, 2);
+            tot_assumption(root, 2, w);
+        }
+    }
+
+    //
+    // !o_k is no longer an assumption; the cost of the remaining 
+    // outputs is carried by !o_{k+1}.
+    //
+    void tot_relax(exprs const& asms, rational const& w) {
+        std::pair<unsigned, unsigned> nk;
+        for (expr* a : asms) {
+            if (m_tot_asm.find(a, nk) && nk.second < m_tot[nk.first].m_size) {
+                tot_extend(nk.first, nk.second + 1);
+                tot_assumption(nk.first, nk.second + 1, w);
+            }
+        }
+    }
+
+    unsigned mk_totalizer(exprs const& core, unsigned lo, unsigned hi) {
+        tot_node n;
+        n.m_size = hi - lo;
+        if (n.m_size == 1) {
+            expr_ref r(mk_not(m, core[lo]), m);
+            m_trail.push_back(r);
+            n.m_left = n.m_right = UINT_MAX;
+            n.m_out.push_back(r);
+        }
+        else {
+            unsigned mid = lo + n.m_size / 2;
+            n.m_left = mk_totalizer(core, lo, mid);
+            n.m_right = mk_totalizer(core, mid, hi);
+        }
+        m_tot.push_back(n);
+        return m_tot.size() - 1;
+    }
+
+    //
+    // o_k := or_{i + j = k} l_i & r_j  where l_0 = r_0 = true
+    // Only the upward clauses l_i & r_j => o_k are needed
+    // for !o_k to bound the number of true inputs.
+    // 
+    void tot_extend(unsigned n, unsigned k) {
+        if (m_tot[n].m_left == UINT_MAX) return;
+        k = std::min(k, m_tot[n].m_size);
+        if (m_tot[n].m_out.size() >= k) return;
+        unsigned l = m_tot[n].m_left, r = m_tot[n].m_right;
+        tot_extend(l, k);
+        tot_extend(r, k);
+        ptr_vector<expr> const& ls = m_tot[l].m_out;
+        ptr_vector<expr> const& rs = m_tot[r].m_out;
+        expr_ref fml(m), value(m);
+        expr_ref_vector disj(m);
+        for (unsigned c = m_tot[n].m_out.size() + 1; c <= k; ++c) {
+            app* o = mk_fresh_bool("t");
+            m_trail.push_back(o);
+            disj.reset();
+            for (unsigned i = 0; i <= c; ++i) {
+                unsigned j = c - i;
+                if (i > ls.size() || j > rs.size()) continue;
+                expr* li = i > 0 ? ls[i-1] : nullptr;
+                expr* rj = j > 0 ? rs[j-1] : nullptr;
+                if (li && rj) {
+                    fml = m.mk_or(mk_not(m, li), mk_not(m, rj), o);
+                    disj.push_back(m.mk_and(li, rj));
+                }
+                else {
+                    expr* lr = li ? li : rj;
+                    fml = m.mk_implies(lr, o);
+                    disj.push_back(lr);
+                }
+                add(fml);
+                m_defs.push_back(fml);
+            }
+            value = mk_or(disj);
+            update_model(o, value);
+            m_tot[n].m_out.push_back(o);
+        }
+    }
+
+    void tot_assumption(unsigned n, unsigned k, rational const& w) {
+        expr_ref a(mk_not(m, m_tot[n].m_out[k-1]), m);
+        rational w0;
+        if (m_asm2weight.find(a, w0) && m_asms.contains(a)) {
+            m_asm2weight.insert(a, w0 + w);
+            return;
+        }
+        m_tot_asm.insert(a, std::make_pair(n, k));
+        new_assumption(a, w);
+    }
+
     // cs is a correction set (a complement of a (maximal) satisfying assignment).
     void cs_max_resolve(exprs const& cs, rational const& w) {
         if (cs.empty()) return;
@@ -815,11 +940,14 @@ public:
         m_pivot_on_cs =             p.maxres_pivot_on_correction_set();
         m_wmax =                    p.maxres_wmax();
         m_dump_benchmarks =         p.dump_benchmarks();
+        m_incremental_totalizer =   p.maxres_incremental_totalizer();
     }
 
     lbool init_local() {
         m_lower.reset();
         m_trail.reset();
+        m_tot.reset();
+        m_tot_asm.reset();
         lbool is_sat = l_true;
         obj_map<expr, rational> new_soft;
         is_sat = find_mutexes(new_soft);
@@ -24,6 +24,7 @@ Notes:
 #include "ast/pb_decl_plugin.h"
 #include "opt/maxsmt.h"
 #include "opt/maxres.h"
+#include "opt/par_maxres.h"
 #include "opt/maxlex.h"
 #include "opt/wmax.h"
 #include "opt/opt_params.hpp"
@@ -152,6 +153,7 @@ namespace opt {
 
 
     void maxsmt_solver_base::trace_bounds(char const * solver) {
+        m_c.bounds_updated(m_lower, m_upper);
         IF_VERBOSE(1, 
                    rational l = m_adjust_value(m_lower);
                    rational u = m_adjust_value(m_upper);
@@ -244,6 +246,9 @@ namespace opt {
         else if (maxsat_engine == symbol("pd-maxres")) {            
             m_msolver = mk_primal_dual_maxres(m_c, m_index, m_weights, m_soft_constraints);
         }
+        else if (maxsat_engine == symbol("par-maxres")) {            
+            m_msolver = mk_par_maxres(m_c, m_index, m_weights, m_soft_constraints);
+        }
         else if (maxsat_engine == symbol("wmax")) {
             m_msolver = mk_wmax(m_c, m_weights, m_soft_constraints);
         }
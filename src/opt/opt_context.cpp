@@ -580,6 +580,22 @@ namespace opt {
         return result;
     }    
 
+    void context::get_objectives(pareto_objectives& objs) {
+        for (objective const& obj : m_objectives) {
+            switch (obj.m_type) {
+            case O_MINIMIZE:
+                objs.add_minimize(obj.m_term);
+                break;
+            case O_MAXIMIZE:
+                objs.add_maximize(obj.m_term);
+                break;
+            case O_MAXSMT:
+                objs.add_maxsat(obj.m_terms.size(), obj.m_terms.c_ptr(), obj.m_weights.c_ptr());
+                break;
+            }
+        }
+    }
+
     expr_ref context::mk_ge(expr* t, expr* s) {
         expr_ref result(m);
         if (m_bv.is_bv(t)) {
@@ -601,7 +617,12 @@ namespace opt {
 
     lbool context::execute_pareto() {        
         if (!m_pareto) {
-            set_pareto(alloc(gia_pareto, m, *this, m_solver.get(), m_params));
+            if (opt_params(m_params).pareto_threads() > 1 && !m.proofs_enabled()) {
+                set_pareto(alloc(par_pareto, m, *this, m_solver.get(), m_params));
+            }
+            else {
+                set_pareto(alloc(gia_pareto, m, *this, m_solver.get(), m_params));
+            }
         }
         lbool is_sat = (*(m_pareto.get()))();
         if (is_sat != l_true) {
@@ -669,6 +690,7 @@ namespace opt {
         }
         if (m_maxsat_engine != symbol("maxres") &&
             m_maxsat_engine != symbol("pd-maxres") &&
+            m_maxsat_engine != symbol("par-maxres") &&
             m_maxsat_engine != symbol("bcd2") &&
             m_maxsat_engine != symbol("sls")) {
             return;
@@ -1476,7 +1498,11 @@ namespace opt {
     }
 
     void context::collect_statistics(statistics& stats) const {
-        if (m_solver) {
+        if (m_pareto) {
+            // the pareto engine reports the statistics of the solvers it uses.
+            m_pareto->collect_statistics(stats);
+        }
+        else if (m_solver) {
             m_solver->collect_statistics(stats);
         }
         if (m_simplify) {
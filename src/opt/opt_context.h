@@ -59,6 +59,7 @@ namespace opt {
         virtual bool verify_model(unsigned id, model* mdl, rational const& v) = 0;
         virtual void set_model(model_ref& _m) = 0;
         virtual void model_updated(model* mdl) = 0;
+        virtual void bounds_updated(rational const& lower, rational const& upper) {} // lower and upper bound on the cost of the current maxsat solver.
     };
 
     /**
@@ -230,6 +231,7 @@ namespace opt {
         expr_ref mk_gt(unsigned i, model_ref& model) override;
         expr_ref mk_ge(unsigned i, model_ref& model) override;
         expr_ref mk_le(unsigned i, model_ref& model) override;
+        void get_objectives(pareto_objectives& objs) override;
 
         generic_model_converter& fm() override { return *m_fm; }
         smt::context& smt_context() override { return m_opt_solver->get_context(); }
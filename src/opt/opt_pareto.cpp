@@ -18,10 +18,20 @@ Notes:
    
 --*/
 
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include "util/scoped_ptr_vector.h"
 #include "opt/opt_pareto.h"
+#include "opt/opt_params.hpp"
 #include "ast/ast_pp.h"
 #include "ast/ast_util.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/bv_decl_plugin.h"
+#include "ast/pb_decl_plugin.h"
 #include "model/model_smt2_pp.h"
+#include "smt/smt_solver.h"
 
 namespace opt {
 
@@ -108,5 +118,539 @@ namespace opt {
         return is_sat;
     }
 
-}
+    // ---------------------------------
+    // objectives shared with workers
+
+    void pareto_objectives::add_term(expr* t, bool is_min) {
+        m_pinned.push_back(t);
+        m_minimize.push_back(is_min);
+        m_terms.push_back(t);
+        m_soft.push_back(ptr_vector<expr>());
+        m_weights.push_back(vector<rational>());
+    }
+
+    void pareto_objectives::add_maxsat(unsigned n, expr* const* soft, rational const* weights) {
+        m_pinned.append(n, soft);
+        m_minimize.push_back(false);
+        m_terms.push_back(nullptr);
+        m_soft.push_back(ptr_vector<expr>(n, soft));
+        m_weights.push_back(vector<rational>(n, weights));
+    }
+
+    pareto_objectives* pareto_objectives::translate(ast_translation& tr) const {
+        pareto_objectives* result = alloc(pareto_objectives, tr.to());
+        for (unsigned i = 0; i < num_objectives(); ++i) {
+            if (m_terms[i]) {
+                result->add_term(tr(m_terms[i]), m_minimize[i]);
+            }
+            else {
+                ptr_vector<expr> soft;
+                for (expr* e : m_soft[i]) {
+                    soft.push_back(tr(e));
+                }
+                result->add_maxsat(soft.size(), soft.c_ptr(), m_weights[i].c_ptr());
+            }
+        }
+        return result;
+    }
+
+    bool pareto_objectives::get_value(unsigned i, model& mdl, rational& v) const {
+        if (!m_terms[i]) {
+            v.reset();
+            for (unsigned j = 0; j < m_soft[i].size(); ++j) {
+                if (mdl.is_true(m_soft[i][j])) {
+                    v += m_weights[i][j];
+                }
+            }
+            return true;
+        }
+        arith_util a(m);
+        bv_util bv(m);
+        unsigned sz;
+        expr_ref val = mdl(m_terms[i]);
+        return a.is_numeral(val, v) || bv.is_numeral(val, v, sz);
+    }
+
+    bool pareto_objectives::is_ge(unsigned i, rational const& a, rational const& b) const {
+        return m_minimize[i] ? a <= b : a >= b;
+    }
+
+    expr_ref pareto_objectives::mk_num(expr* t, rational const& v) {
+        arith_util a(m);
+        bv_util bv(m);
+        if (bv.is_bv(t)) {
+            return expr_ref(bv.mk_numeral(v, m.get_sort(t)), m);
+        }
+        return expr_ref(a.mk_numeral(v, a.is_int(t)), m);
+    }
+
+    expr_ref pareto_objectives::mk_ge(unsigned i, rational const& v) {
+        expr* t = m_terms[i];
+        if (!t) {
+            pb_util pb(m);
+            return expr_ref(pb.mk_ge(m_soft[i].size(), m_weights[i].c_ptr(), m_soft[i].c_ptr(), v), m);
+        }
+        expr_ref n = mk_num(t, v);
+        bv_util bv(m);
+        arith_util a(m);
+        if (m_minimize[i]) {
+            return expr_ref(bv.is_bv(t) ? bv.mk_ule(t, n) : a.mk_le(t, n), m);
+        }
+        return expr_ref(bv.is_bv(t) ? bv.mk_ule(n, t) : a.mk_ge(t, n), m);
+    }
+
+    expr_ref pareto_objectives::mk_le(unsigned i, rational const& v) {
+        expr* t = m_terms[i];
+        if (!t) {
+            pb_util pb(m);
+            return expr_ref(pb.mk_le(m_soft[i].size(), m_weights[i].c_ptr(), m_soft[i].c_ptr(), v), m);
+        }
+        expr_ref n = mk_num(t, v);
+        bv_util bv(m);
+        arith_util a(m);
+        if (m_minimize[i]) {
+            return expr_ref(bv.is_bv(t) ? bv.mk_ule(n, t) : a.mk_ge(t, n), m);
+        }
+        return expr_ref(bv.is_bv(t) ? bv.mk_ule(t, n) : a.mk_le(t, n), m);
+    }
+
+    // ---------------------------------
+    // parallel pareto front enumeration
+
+    struct par_pareto::imp {
+
+        struct stats {
+            unsigned m_num_boxes;
+            unsigned m_num_points;
+            unsigned m_num_dominated;
+            unsigned m_num_pruned;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        /**
+           \brief box of solutions that improve objective m_obj of point m_point.
+           The box with m_point == UINT_MAX covers the entire objective space.
+        */
+        struct box {
+            unsigned m_point;
+            unsigned m_obj;
+            box(unsigned p = UINT_MAX, unsigned o = 0): m_point(p), m_obj(o) {}
+        };
+
+        /**
+           \brief a pareto point handed to the caller.
+           The model lives in a manager owned by the point, so that it 
+           can be translated to the caller's manager without touching
+           the manager of the worker that found it.
+        */
+        struct point {
+            ast_manager*    m_manager;
+            model_ref       m_model;
+            svector<symbol> m_labels;
+            point(ast_manager* m): m_manager(m) {}
+            ~point() { m_model = nullptr; dealloc(m_manager); }
+        };
+
+        class worker {
+            imp&                          p;
+            ast_manager&                  m;
+            ref<solver>                   m_solver;
+            scoped_ptr<pareto_objectives> m_objs;
+            unsigned                      m_synced;
+            statistics                    m_solver_stats;   // snapshot of m_solver's statistics, guarded by p.m_mux
+
+            // exclude points dominated by the pareto points found so far.
+            void sync(unsigned& synced) {
+                vector<vector<rational>> front;
+                {
+                    std::lock_guard<std::mutex> lock(p.m_mux);
+                    for (unsigned i = synced; i < p.m_front.size(); ++i) {
+                        front.push_back(p.m_front[i]);
+                    }
+                    synced = p.m_front.size();
+                }
+                for (auto const& vals : front) {
+                    expr_ref_vector gt(m);
+                    for (unsigned i = 0; i < vals.size(); ++i) {
+                        gt.push_back(m_objs->mk_gt(i, vals[i]));
+                    }
+                    m_solver->assert_expr(mk_or(gt));
+                }
+            }
+
+            bool get_values(model& mdl, vector<rational>& vals) {
+                vals.reset();
+                for (unsigned i = 0; i < m_objs->num_objectives(); ++i) {
+                    rational v;
+                    if (!m_objs->get_value(i, mdl, v)) {
+                        return false;
+                    }
+                    vals.push_back(v);
+                }
+                return true;
+            }
+
+            void mk_dominates(vector<rational> const& vals) {
+                expr_ref_vector ge(m), gt(m);
+                for (unsigned i = 0; i < vals.size(); ++i) {
+                    ge.push_back(m_objs->mk_ge(i, vals[i]));
+                    gt.push_back(m_objs->mk_gt(i, vals[i]));
+                }
+                ge.push_back(mk_or(gt));
+                m_solver->assert_expr(mk_and(ge));
+            }
+
+            void solve(box const& b) {
+                sync(m_synced);
+                unsigned synced = m_synced;
+                solver::scoped_push _s(*m_solver.get());
+                if (b.m_point != UINT_MAX) {
+                    rational v;
+                    {
+                        std::lock_guard<std::mutex> lock(p.m_mux);
+                        v = p.m_front[b.m_point][b.m_obj];
+                    }
+                    m_solver->assert_expr(m_objs->mk_gt(b.m_obj, v));
+                }
+                lbool is_sat = m_solver->check_sat(0, nullptr);
+                if (is_sat == l_false) {
+                    p.set_empty(b);
+                }
+                if (is_sat == l_undef && !m.canceled()) {
+                    p.set_error(m_solver->reason_unknown());
+                }
+                if (is_sat != l_true) {
+                    return;
+                }
+                model_ref mdl;
+                vector<rational> vals;
+                svector<symbol> labels;
+                while (is_sat == l_true) {
+                    m_solver->get_model(mdl);
+                    m_solver->get_labels(labels);
+                    mdl->set_model_completion(true);
+                    if (!get_values(*mdl, vals)) {
+                        throw default_exception("parallel pareto enumeration requires numeral objective values");
+                    }
+                    mk_dominates(vals);
+                    // points found meanwhile by other workers prune the climb.
+                    // A climb that ends in a dominated point is discarded by publish.
+                    sync(synced);
+                    is_sat = m_solver->check_sat(0, nullptr);
+                }
+                if (is_sat == l_false) {
+                    p.publish(m, mdl, labels, vals);
+                }
+                else if (!m.canceled()) {
+                    p.set_error(m_solver->reason_unknown());
+                }
+            }
+
+        public:
+            worker(imp& p, ast_manager& m, ast_translation& tr, expr_ref_vector const& fmls, 
+                   pareto_objectives const& objs, params_ref const& params):
+                p(p), m(m), m_synced(0) {
+                m_solver = mk_smt_solver(m, params, symbol::null);
+                for (expr* f : fmls) {
+                    m_solver->assert_expr(tr(f));
+                }
+                m_objs = objs.translate(tr);
+            }
+
+            void operator()() {
+                try {
+                    box b;
+                    while (!m.canceled() && p.next_box(b)) {
+                        solve(b);
+                        snapshot_stats();
+                        p.box_done();
+                    }
+                }
+                catch (z3_exception& ex) {
+                    p.set_error(ex.msg());
+                }
+                snapshot_stats();
+                p.worker_done();
+            }
+
+            // the solver keeps running between calls from the caller, 
+            // so its statistics are read from a snapshot.
+            void snapshot_stats() {
+                statistics st;
+                m_solver->collect_statistics(st);
+                std::lock_guard<std::mutex> lock(p.m_mux);
+                m_solver_stats.reset();
+                m_solver_stats.copy(st);
+            }
 
+            void collect_statistics(statistics& st) const {
+                st.copy(m_solver_stats);
+            }
+        };
+
+        ast_manager&                   m;
+        std::mutex                     m_mux;
+        std::condition_variable        m_cond;
+        vector<vector<rational>>       m_front;     // objective values of points found so far
+        svector<box>                   m_boxes;
+        vector<rational>               m_empty;     // boxes beyond m_empty[i] in objective i are empty
+        svector<bool>                  m_has_empty;
+        ptr_vector<point>              m_ready;
+        unsigned                       m_ready_head;
+        unsigned                       m_num_busy;
+        unsigned                       m_num_running;
+        bool                           m_done;
+        std::string                    m_error;
+        stats                          m_stats;
+        scoped_ptr<pareto_objectives>  m_objs;
+        scoped_ptr_vector<ast_manager> m_managers;
+        scoped_ptr_vector<worker>      m_workers;
+        vector<std::thread>            m_threads;
+
+        imp(ast_manager& m): 
+            m(m), m_ready_head(0), m_num_busy(0), m_num_running(0), m_done(false) {}
+
+        ~imp() {
+            cancel();
+            for (auto& th : m_threads) {
+                th.join();
+            }
+            for (unsigned i = m_ready_head; i < m_ready.size(); ++i) {
+                dealloc(m_ready[i]);
+            }
+            m_workers.reset();
+        }
+
+        void collect_statistics(statistics& st) {
+            std::lock_guard<std::mutex> lock(m_mux);
+            for (worker* w : m_workers) {
+                w->collect_statistics(st);
+            }
+        }
+
+        void cancel() {
+            std::lock_guard<std::mutex> lock(m_mux);
+            m_done = true;
+            for (ast_manager* wm : m_managers) {
+                wm->limit().cancel();
+            }
+            m_cond.notify_all();
+        }
+
+        bool is_pruned(box const& b) const {
+            return 
+                b.m_point != UINT_MAX && m_has_empty[b.m_obj] &&
+                m_objs->is_ge(b.m_obj, m_front[b.m_point][b.m_obj], m_empty[b.m_obj]);
+        }
+
+        bool next_box(box& b) {
+            std::unique_lock<std::mutex> lock(m_mux);
+            while (true) {
+                m_cond.wait(lock, [&]() { return m_done || !m_boxes.empty() || m_num_busy == 0; });
+                if (m_done || m_boxes.empty()) {
+                    m_done = true;
+                    m_cond.notify_all();
+                    return false;
+                }
+                b = m_boxes.back();
+                m_boxes.pop_back();
+                if (!is_pruned(b)) {
+                    break;
+                }
+                ++m_stats.m_num_pruned;
+            }
+            ++m_num_busy;
+            ++m_stats.m_num_boxes;
+            return true;
+        }
+
+        /**
+           \brief box b has no solutions that are not dominated by the current front.
+           Neither have boxes that require a better value for the same objective,
+           because the front only grows.
+        */
+        void set_empty(box const& b) {
+            std::lock_guard<std::mutex> lock(m_mux);
+            if (b.m_point == UINT_MAX) {
+                m_boxes.reset();
+                return;
+            }
+            rational const& v = m_front[b.m_point][b.m_obj];
+            if (!m_has_empty[b.m_obj] || m_objs->is_ge(b.m_obj, m_empty[b.m_obj], v)) {
+                m_empty[b.m_obj] = v;
+                m_has_empty[b.m_obj] = true;
+            }
+        }
+
+        void box_done() {
+            std::lock_guard<std::mutex> lock(m_mux);
+            --m_num_busy;
+            m_cond.notify_all();
+        }
+
+        void worker_done() {
+            std::lock_guard<std::mutex> lock(m_mux);
+            --m_num_running;
+            m_cond.notify_all();
+        }
+
+        void set_error(std::string const& msg) {
+            std::lock_guard<std::mutex> lock(m_mux);
+            if (m_error.empty()) {
+                m_error = msg;
+            }
+            m_done = true;
+            m_cond.notify_all();
+        }
+
+        bool is_dominated(vector<rational> const& vals) const {
+            for (auto const& f : m_front) {
+                bool dominated = true;
+                for (unsigned i = 0; dominated && i < vals.size(); ++i) {
+                    dominated = m_objs->is_ge(i, f[i], vals[i]);
+                }
+                if (dominated) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+           \brief add a point that could not be improved.
+           It is a pareto point unless it is dominated by a point 
+           that was published after the worker last synchronized.
+        */
+        void publish(ast_manager& wm, model_ref& mdl, svector<symbol> const& labels, vector<rational> const& vals) {
+            {
+                std::lock_guard<std::mutex> lock(m_mux);
+                if (is_dominated(vals)) {
+                    ++m_stats.m_num_dominated;
+                    return;
+                }
+                unsigned idx = m_front.size();
+                m_front.push_back(vals);
+                for (unsigned i = 0; i < vals.size(); ++i) {
+                    m_boxes.push_back(box(idx, i));
+                }
+                ++m_stats.m_num_points;
+                m_cond.notify_all();
+            }
+            point* pt = alloc(point, alloc(ast_manager, wm, !wm.proof_mode()));
+            ast_translation tr(wm, *pt->m_manager);
+            pt->m_model = mdl->translate(tr);
+            pt->m_labels = labels;
+            std::lock_guard<std::mutex> lock(m_mux);
+            m_ready.push_back(pt);
+            m_cond.notify_all();
+        }
+
+        void start(solver& s, pareto_objectives* objs, params_ref const& p, unsigned num_threads) {
+            m_objs = objs;
+            m_empty.resize(objs->num_objectives());
+            m_has_empty.resize(objs->num_objectives(), false);
+            expr_ref_vector fmls(m);
+            s.get_assertions(fmls);
+            unsigned seed = p.get_uint("random_seed", 0);
+            for (unsigned i = 0; i < num_threads; ++i) {
+                ast_manager* new_m = alloc(ast_manager, m, !m.proof_mode());
+                m_managers.push_back(new_m);
+                ast_translation tr(m, *new_m);
+                params_ref wp(p);
+                wp.set_uint("random_seed", seed + i);
+                m_workers.push_back(alloc(worker, *this, *new_m, tr, fmls, *objs, wp));
+                m_boxes.push_back(box());
+            }
+            m_num_running = num_threads;
+            for (worker* w : m_workers) {
+                m_threads.push_back(std::thread([w]() { (*w)(); }));
+            }
+        }
+
+        /**
+           \brief wait for the next pareto point.
+           Returns l_undef if the enumeration was canceled or if
+           a worker could not complete a box.
+        */
+        lbool next(model_ref& mdl, svector<symbol>& labels) {
+            point* pt = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(m_mux);
+                while (m_ready_head == m_ready.size() && m_num_running > 0 && !m.canceled()) {
+                    m_cond.wait_for(lock, std::chrono::milliseconds(10));
+                }
+                if (m_ready_head < m_ready.size()) {
+                    pt = m_ready[m_ready_head++];
+                }
+            }
+            if (pt) {
+                ast_translation tr(*pt->m_manager, m);
+                mdl = pt->m_model->translate(tr);
+                labels = pt->m_labels;
+                dealloc(pt);
+                return l_true;
+            }
+            if (m.canceled()) {
+                cancel();
+                return l_undef;
+            }
+            if (!m_error.empty()) {
+                IF_VERBOSE(1, verbose_stream() << "(opt.par-pareto " << m_error << ")\n";);
+                return l_undef;
+            }
+            return l_false;
+        }
+    };
+
+    par_pareto::par_pareto(ast_manager & m, pareto_callback& cb, solver* s, params_ref & p):
+        pareto_base(m, cb, s, p),
+        m_imp(nullptr),
+        m_num_threads(opt_params(p).pareto_threads()) {
+    }
+
+    par_pareto::~par_pareto() {
+        dealloc(m_imp);
+    }
+
+    lbool par_pareto::operator()() {
+        if (m_fallback) {
+            lbool r = (*m_fallback)();
+            m_fallback->get_model(m_model, m_labels);
+            return r;
+        }
+        bool first = !m_imp;
+        if (first) {
+            pareto_objectives* objs = alloc(pareto_objectives, m);
+            cb.get_objectives(*objs);
+            m_imp = alloc(imp, m);
+            m_imp->start(*m_solver, objs, m_params, m_num_threads);
+        }
+        lbool r = m_imp->next(m_model, m_labels);
+        if (r == l_true) {
+            m_model->set_model_completion(true);
+        }
+        if (r == l_undef && first && !m.canceled()) {
+            // workers failed before producing a point, e.g., because objective values 
+            // are not numerals or the theories are incomplete. Use the sequential 
+            // algorithm, which also reports the reason.
+            dealloc(m_imp);
+            m_imp = nullptr;
+            m_fallback = alloc(gia_pareto, m, cb, m_solver.get(), m_params);
+            return (*this)();
+        }
+        return r;
+    }
+
+    void par_pareto::collect_statistics(statistics & st) const {
+        pareto_base::collect_statistics(st);
+        if (m_imp) {
+            m_imp->collect_statistics(st);
+            st.update("pareto-boxes", m_imp->m_stats.m_num_boxes);
+            st.update("pareto-points", m_imp->m_stats.m_num_points);
+            st.update("pareto-dominated", m_imp->m_stats.m_num_dominated);
+            st.update("pareto-pruned", m_imp->m_stats.m_num_pruned);
+        }
+    }
+
+}
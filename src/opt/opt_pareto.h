@@ -20,10 +20,41 @@ Notes:
 #ifndef OPT_PARETO_H_
 #define OPT_PARETO_H_
 
+#include "ast/ast_translation.h"
 #include "solver/solver.h"
 #include "model/model.h"
 
 namespace opt {
+
+    /**
+       \brief objectives in a form that can be copied between managers.
+       Objective values are compared with respect to the direction 
+       of the objective: mk_ge(i, v) holds if objective i is at least 
+       as good as v.
+    */
+    class pareto_objectives {
+        ast_manager&               m;
+        expr_ref_vector            m_pinned;
+        svector<bool>              m_minimize;
+        ptr_vector<expr>           m_terms;     // nullptr for max-sat objectives
+        vector<ptr_vector<expr>>   m_soft;
+        vector<vector<rational>>   m_weights;
+    public:
+        pareto_objectives(ast_manager& m): m(m), m_pinned(m) {}
+        unsigned num_objectives() const { return m_minimize.size(); }
+        void add_maximize(expr* t) { add_term(t, false); }
+        void add_minimize(expr* t) { add_term(t, true); }
+        void add_maxsat(unsigned n, expr* const* soft, rational const* weights);
+        pareto_objectives* translate(ast_translation& tr) const;
+        bool get_value(unsigned i, model& mdl, rational& v) const;
+        bool is_ge(unsigned i, rational const& a, rational const& b) const;
+        expr_ref mk_ge(unsigned i, rational const& v);
+        expr_ref mk_le(unsigned i, rational const& v);
+        expr_ref mk_gt(unsigned i, rational const& v) { return expr_ref(m.mk_not(mk_le(i, v)), m); }
+    private:
+        void add_term(expr* t, bool is_min);
+        expr_ref mk_num(expr* t, rational const& v);
+    };
    
     class pareto_callback {
     public:
@@ -32,6 +63,7 @@ namespace opt {
         virtual expr_ref mk_ge(unsigned i, model_ref& model) = 0;
         virtual expr_ref mk_le(unsigned i, model_ref& model) = 0;
         virtual void fix_model(model_ref& m) = 0;
+        virtual void get_objectives(pareto_objectives& objs) = 0;
     };
     class pareto_base {
     protected:
@@ -105,6 +137,35 @@ namespace opt {
 
         lbool operator()() override;
     };
+
+    /**
+       \brief enumerate the pareto front on several threads.
+
+       Each worker owns a copy of the hard constraints in its own
+       manager. The part of the objective space that is not dominated
+       by the points found so far is split into boxes: a point p 
+       contributes one box per objective i with the solutions that
+       are better than p in objective i. Workers take boxes from a
+       shared queue, exclude the points found by all workers, and 
+       climb to a pareto point inside the box. Points are returned 
+       to the caller as soon as they are found.
+    */
+    class par_pareto : public pareto_base {
+        struct imp;
+        imp*              m_imp;
+        unsigned          m_num_threads;
+        scoped_ptr<pareto_base> m_fallback;
+    public:
+        par_pareto(ast_manager & m, 
+                   pareto_callback& cb, 
+                   solver* s, 
+                   params_ref & p);
+        ~par_pareto() override;
+
+        lbool operator()() override;
+
+        void collect_statistics(statistics & st) const override;
+    };
 }
 
 #endif
@@ -0,0 +1,431 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    par_maxres.cpp
+
+Abstract:
+
+    Parallel portfolio for (weighted) max-sat.
+
+    Each worker runs on its own copy of the hard constraints, in its
+    own ast_manager, using one of the sequential engines:
+
+    - maxres with hill climbing: cores are extracted from the
+      strata of large weight soft constraints first.
+    - maxres without hill climbing: cores over all soft constraints.
+    - pd-maxres: primal-dual refinement that also uses correction
+      sets to improve the upper bound.
+    - an upper bound worker: maxres with local search model
+      improvement when the SAT core is used, wmax otherwise.
+
+    Additional workers repeat the portfolio with different seeds.
+
+    Workers publish lower bounds obtained from cores and upper
+    bounds obtained from models into a shared cell. The search
+    stops as soon as the best lower bound meets the best upper bound,
+    or when one worker finishes. The model attaining the best
+    upper bound is translated back to the main manager.
+
+Notes:
+
+    Objective values of models found by workers are checked against
+    the objective term only after the model is translated back.
+    If this check fails, the sequential maxres engine is used.
+
+--*/
+
+#include <thread>
+#include <mutex>
+#include "util/scoped_ptr_vector.h"
+#include "ast/ast_translation.h"
+#include "tactic/generic_model_converter.h"
+#include "solver/solver.h"
+#include "sat/sat_solver/inc_sat_solver.h"
+#include "opt/opt_context.h"
+#include "opt/opt_params.hpp"
+#include "opt/opt_solver.h"
+#include "opt/maxsmt.h"
+#include "opt/maxres.h"
+#include "opt/wmax.h"
+#include "opt/par_maxres.h"
+
+using namespace opt;
+
+class par_maxres : public maxsmt_solver_base {
+
+    struct stats {
+        unsigned m_num_lower_updates;
+        unsigned m_num_upper_updates;
+        stats() { reset(); }
+        void reset() { memset(this, 0, sizeof(*this)); }
+    };
+
+    /**
+       \brief bounds shared by the workers.
+       m_upper is attained by the best model of worker m_best.
+    */
+    struct shared_bounds {
+        std::mutex mux;
+        rational   m_lower;
+        rational   m_upper;
+        unsigned   m_best;
+        bool       m_done;
+        shared_bounds(): m_best(UINT_MAX), m_done(false) {}
+    };
+
+    enum worker_kind {
+        w_hill_climb,
+        w_flat_cores,
+        w_primal_dual,
+        w_upper_bound
+    };
+
+    class worker : public maxsat_context {
+        par_maxres&                    p;
+        unsigned                       m_id;
+        ast_manager&                   m;
+        ref<generic_model_converter>   m_fm;
+        params_ref                     m_params;
+        bool                           m_sat_enabled;
+        bool                           m_enable_sls;
+        unsigned                       m_num_objectives;
+        ref<opt_solver>                m_opt_solver;
+        ref<solver>                    m_solver;
+        model_ref                      m_base_model;
+        symbol                         m_engine;
+        expr_ref_vector                m_soft;
+        vector<rational>               m_weights;
+        model_ref                      m_best_model;
+        lbool                          m_result;
+        std::string                    m_error;
+
+        rational cost(model& mdl) const {
+            rational r(0);
+            for (unsigned i = 0; i < m_soft.size(); ++i) {
+                if (!mdl.is_true(m_soft.get(i))) {
+                    r += m_weights[i];
+                }
+            }
+            return r;
+        }
+
+    public:
+        worker(par_maxres& p, unsigned id, worker_kind k, ast_manager& m, ast_translation& tr,
+               expr_ref_vector const& fmls, params_ref const& params):
+            p(p),
+            m_id(id),
+            m(m),
+            m_fm(alloc(generic_model_converter, m, "par-maxres")),
+            m_params(params),
+            m_sat_enabled(p.m_c.sat_enabled()),
+            m_enable_sls(false),
+            m_num_objectives(p.m_c.num_objectives()),
+            m_soft(m),
+            m_result(l_undef) {
+            switch (k) {
+            case w_hill_climb:
+                m_engine = symbol("maxres");
+                m_params.set_bool("maxres.hill_climb", true);
+                break;
+            case w_flat_cores:
+                m_engine = symbol("maxres");
+                m_params.set_bool("maxres.hill_climb", false);
+                m_params.set_bool("maxres.pivot_on_correction_set", false);
+                break;
+            case w_primal_dual:
+                m_engine = symbol("pd-maxres");
+                break;
+            case w_upper_bound:
+                m_engine = m_sat_enabled ? symbol("maxres") : symbol("wmax");
+                m_enable_sls = m_sat_enabled;
+                break;
+            }
+            if (m_sat_enabled) {
+                m_solver = mk_inc_sat_solver(m, m_params);
+            }
+            else {
+                m_opt_solver = alloc(opt_solver, m, m_params, *m_fm);
+                m_opt_solver->ensure_pb();
+                m_solver = m_opt_solver.get();
+            }
+            for (expr* f : fmls) {
+                m_solver->assert_expr(tr(f));
+            }
+            for (auto const& s : p.m_soft) {
+                m_soft.push_back(tr(s.s.get()));
+                m_weights.push_back(s.weight);
+            }
+            m_base_model = p.m_model->translate(tr);
+            enable_sls(false);
+        }
+
+        generic_model_converter& fm() override { return *m_fm; }
+        bool sat_enabled() const override { return m_sat_enabled; }
+        solver& get_solver() override { return *m_solver; }
+        ast_manager& get_manager() const override { return m; }
+        params_ref& params() override { return m_params; }
+        symbol const& maxsat_engine() const override { return m_engine; }
+        void get_base_model(model_ref& mdl) override { mdl = m_base_model; }
+        unsigned num_objectives() override { return m_num_objectives; }
+        bool verify_model(unsigned id, model* mdl, rational const& v) override { return true; }
+        void set_model(model_ref& mdl) override {}
+
+        smt::context& smt_context() override {
+            if (!m_opt_solver) {
+                throw default_exception("par-maxres worker does not use the SMT core");
+            }
+            return m_opt_solver->get_context();
+        }
+
+        void enable_sls(bool force) override {
+            if ((force || m_enable_sls) && m_sat_enabled) {
+                m_params.set_bool("optimize_model", true);
+                m_solver->updt_params(m_params);
+            }
+        }
+
+        void model_updated(model* mdl) override {
+            rational c = cost(*mdl);
+            std::lock_guard<std::mutex> lock(p.m_shared.mux);
+            if (p.update_upper(m_id, c)) {
+                m_best_model = mdl;
+            }
+        }
+
+        void bounds_updated(rational const& lower, rational const& upper) override {
+            std::lock_guard<std::mutex> lock(p.m_shared.mux);
+            p.update_lower(lower);
+        }
+
+        void operator()() {
+            try {
+                scoped_ptr<maxsmt_solver_base> ms;
+                if (m_engine == symbol("wmax")) {
+                    ms = mk_wmax(*this, m_weights, m_soft);
+                }
+                else if (m_engine == symbol("pd-maxres")) {
+                    ms = mk_primal_dual_maxres(*this, p.m_index, m_weights, m_soft);
+                }
+                else {
+                    ms = mk_maxres(*this, p.m_index, m_weights, m_soft);
+                }
+                ms->updt_params(m_params);
+                m_result = (*ms)();
+                if (m_result == l_true && !m.canceled()) {
+                    model_ref mdl;
+                    svector<symbol> labels;
+                    ms->get_model(mdl, labels);
+                    std::lock_guard<std::mutex> lock(p.m_shared.mux);
+                    if (mdl && p.update_upper(m_id, ms->get_upper())) {
+                        m_best_model = mdl;
+                    }
+                    p.update_lower(ms->get_upper());
+                }
+            }
+            catch (z3_exception& ex) {
+                m_result = l_undef;
+                m_error = ex.msg();
+            }
+        }
+
+        lbool result() const { return m_result; }
+        std::string const& error() const { return m_error; }
+
+        /**
+           \brief retrieve the best model of this worker in the manager dst.
+        */
+        model_ref get_best_model(ast_manager& dst) {
+            model_ref mdl = m_best_model;
+            if (!mdl) {
+                return mdl;
+            }
+            (*m_fm)(mdl);
+            ast_translation tr(m, dst);
+            mdl = mdl->translate(tr);
+            return mdl;
+        }
+    };
+
+    unsigned                  m_index;
+    unsigned                  m_num_threads;
+    stats                     m_stats;
+    shared_bounds             m_shared;
+    ptr_vector<ast_manager>   m_worker_managers;
+
+    /**
+       \brief update the shared upper bound.
+       The caller holds the lock and supplies the model attaining the bound
+       if the bound is improved.
+    */
+    bool update_upper(unsigned id, rational const& upper) {
+        if (m_shared.m_best != UINT_MAX && upper >= m_shared.m_upper) {
+            return false;
+        }
+        m_shared.m_upper = upper;
+        m_shared.m_best = id;
+        ++m_stats.m_num_upper_updates;
+        IF_VERBOSE(2, verbose_stream() << "(opt.par-maxres worker " << id << " upper: " << upper << ")\n";);
+        check_done();
+        return true;
+    }
+
+    void update_lower(rational const& lower) {
+        if (lower <= m_shared.m_lower) {
+            return;
+        }
+        m_shared.m_lower = lower;
+        ++m_stats.m_num_lower_updates;
+        IF_VERBOSE(2, verbose_stream() << "(opt.par-maxres lower: " << lower << ")\n";);
+        check_done();
+    }
+
+    void check_done() {
+        if (m_shared.m_done || m_shared.m_best == UINT_MAX || m_shared.m_lower < m_shared.m_upper) {
+            return;
+        }
+        m_shared.m_done = true;
+        for (ast_manager* wm : m_worker_managers) {
+            wm->limit().cancel();
+        }
+    }
+
+    params_ref worker_params(unsigned i) {
+        params_ref p;
+        p.copy(m_c.params());
+        p.copy(m_params);
+        unsigned seed = p.get_uint("random_seed", 0);
+        p.set_uint("random_seed", seed + i);
+        return p;
+    }
+
+    lbool run_sequential() {
+        expr_ref_vector soft(m);
+        vector<rational> weights;
+        for (auto const& s : m_soft) {
+            soft.push_back(s.s);
+            weights.push_back(s.weight);
+        }
+        scoped_ptr<maxsmt_solver_base> ms = mk_maxres(m_c, m_index, weights, soft);
+        ms->updt_params(m_params);
+        ms->set_adjust_value(m_adjust_value);
+        lbool r = (*ms)();
+        m_lower = ms->get_lower();
+        m_upper = ms->get_upper();
+        ms->get_model(m_model, m_labels);
+        for (unsigned i = 0; i < m_soft.size(); ++i) {
+            m_soft[i].set_value(ms->get_assignment(i));
+        }
+        return r;
+    }
+
+    bool set_best_model(model_ref& mdl) {
+        mdl->set_model_completion(true);
+        rational upper(0);
+        for (soft& s : m_soft) {
+            if (!mdl->is_true(s.s)) {
+                upper += s.weight;
+            }
+        }
+        if (upper > m_upper || !m_c.verify_model(m_index, mdl.get(), upper)) {
+            return false;
+        }
+        m_model = mdl;
+        m_c.model_updated(mdl.get());
+        for (soft& s : m_soft) {
+            s.set_value(m_model->is_true(s.s));
+        }
+        m_upper = upper;
+        return true;
+    }
+
+public:
+    par_maxres(maxsat_context& c, unsigned index, weights_t& ws, expr_ref_vector const& soft):
+        maxsmt_solver_base(c, ws, soft),
+        m_index(index),
+        m_num_threads(1) {
+    }
+
+    ~par_maxres() override {}
+
+    lbool operator()() override {
+        if (!init()) return l_undef;
+        if (m_num_threads <= 1 || m.proofs_enabled()) {
+            return run_sequential();
+        }
+        trace_bounds("par-maxres");
+
+        expr_ref_vector fmls(m);
+        s().get_assertions(fmls);
+
+        scoped_ptr_vector<ast_manager> managers;
+        scoped_limits scl(m.limit());
+        scoped_ptr_vector<worker> workers;
+        m_shared.m_lower.reset();
+        m_shared.m_upper = m_upper;
+        m_shared.m_best = UINT_MAX;
+        m_shared.m_done = false;
+        for (unsigned i = 0; i < m_num_threads; ++i) {
+            ast_manager* new_m = alloc(ast_manager, m, !m.proof_mode());
+            managers.push_back(new_m);
+            ast_translation tr(m, *new_m);
+            workers.push_back(alloc(worker, *this, i, static_cast<worker_kind>(i % 4), *new_m, tr, fmls, worker_params(i)));
+            scl.push_child(&new_m->limit());
+            m_worker_managers.push_back(new_m);
+        }
+
+        vector<std::thread> threads(m_num_threads);
+        for (unsigned i = 0; i < m_num_threads; ++i) {
+            threads[i] = std::thread([&, i]() { (*workers[i])(); });
+        }
+        for (auto& th : threads) {
+            th.join();
+        }
+        m_worker_managers.reset();
+
+        bool is_infeasible = false;
+        std::string error;
+        for (worker* w : workers) {
+            is_infeasible |= w->result() == l_false;
+            if (error.empty()) error = w->error();
+        }
+        if (is_infeasible && !m.canceled()) {
+            return l_false;
+        }
+        if (m_shared.m_best != UINT_MAX) {
+            model_ref mdl = workers[m_shared.m_best]->get_best_model(m);
+            if (!set_best_model(mdl)) {
+                IF_VERBOSE(1, verbose_stream() << "(opt.par-maxres model could not be validated, retrying sequentially)\n";);
+                return run_sequential();
+            }
+        }
+        if (m_shared.m_done) {
+            m_lower = m_upper;
+            trace_bounds("par-maxres");
+            return l_true;
+        }
+        m_lower = std::min(m_shared.m_lower, m_upper);
+        trace_bounds("par-maxres");
+        if (!m.canceled() && !error.empty()) {
+            throw default_exception(std::move(error));
+        }
+        return l_undef;
+    }
+
+    void updt_params(params_ref& _p) override {
+        maxsmt_solver_base::updt_params(_p);
+        opt_params p(_p);
+        m_num_threads = p.maxres_threads();
+    }
+
+    void collect_statistics(statistics& st) const override {
+        st.update("par-maxres-lower-updates", m_stats.m_num_lower_updates);
+        st.update("par-maxres-upper-updates", m_stats.m_num_upper_updates);
+    }
+};
+
+opt::maxsmt_solver_base* opt::mk_par_maxres(
+    maxsat_context& c, unsigned id, weights_t& ws, expr_ref_vector const& soft) {
+    return alloc(par_maxres, c, id, ws, soft);
+}
@@ -0,0 +1,26 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    par_maxres.h
+
+Abstract:
+
+    Portfolio of core-guided and model-improving MaxSAT workers
+    running on separate threads and sharing bounds.
+
+Notes:
+
+--*/
+
+#ifndef PAR_MAXRES_H_
+#define PAR_MAXRES_H_
+
+namespace opt {
+
+    maxsmt_solver_base* mk_par_maxres(maxsat_context& c, unsigned id, weights_t & ws, expr_ref_vector const& soft);
+
+};
+
+#endif
@@ -603,7 +603,7 @@ private:
             }
         }
         catch (tactic_exception & ex) {
-            IF_VERBOSE(0, verbose_stream() << "exception in tactic " << ex.msg() << "\n";);
+            IF_VERBOSE(0, if (!m.canceled()) verbose_stream() << "exception in tactic " << ex.msg() << "\n";);
             TRACE("sat", tout << "exception: " << ex.msg() << "\n";);
             m_preprocess = nullptr;
             m_bb_rewriter = nullptr;
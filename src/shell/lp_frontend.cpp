@@ -14,6 +14,7 @@ Author:
 #include "util/scoped_timer.h"
 #include "util/rlimit.h"
 #include "util/gparams.h"
+#include "util/stopwatch.h"
 #include <signal.h>
 #include "smt/params/smt_params_helper.hpp"
 
@@ -50,6 +51,39 @@ struct front_end_resource_limit : public lp::lp_resource_limit {
     bool get_cancel_flag() override { return !m_reslim.inc(); }
 };
 
+/**
+   \brief Check feasibility of the constraints of an mps file with the exact
+   lar_solver. The simplex strategy and the floating point presolve are taken
+   from arith.simplex_strategy and arith.presolve_with_doubles, so the
+   configurations can be compared on the same input.
+*/
+void run_lar_solver(smt_params_helper & params, lp::lp_resource_limit & lp_limit, char const * mps_file_name) {
+    lp::mps_reader<lp::mpq, lp::mpq> reader(mps_file_name);
+    reader.set_message_stream(&std::cout);
+    reader.read();
+    if (!reader.is_ok()) {
+        std::cerr << "cannot process " << mps_file_name << std::endl;
+        return;
+    }
+    scoped_ptr<lp::lar_solver> solver = alloc(lp::lar_solver);
+    solver->settings().set_resource_limit(lp_limit);
+    solver->settings().set_message_ostream(&std::cout);
+    solver->settings().report_frequency = params.arith_rep_freq();
+    solver->settings().print_statistics = params.arith_print_stats();
+    solver->settings().simplex_strategy() = static_cast<lp::simplex_strategy_enum>(params.arith_simplex_strategy());
+    solver->settings().presolve_with_double_solver_for_lar = params.arith_presolve_with_doubles();
+    // the strategy decides which matrices the columns are added to,
+    // so it is set before the solver is filled
+    reader.fill_lar_solver(solver.get());
+    stopwatch sw;
+    sw.start();
+    lp::lp_status status = solver->solve();
+    sw.stop();
+    std::cout << "status is " << lp_status_to_string(status) 
+              << ", processed for " << sw.get_seconds() << " seconds, and " 
+              << solver->get_total_iterations() << " iterations" << std::endl;
+}
+
 void run_solver(smt_params_helper & params, char const * mps_file_name) {
 
     reslimit rlim;
@@ -61,6 +95,11 @@ void run_solver(smt_params_helper & params, char const * mps_file_name) {
     cancel_eh<reslimit> eh(rlim);
     scoped_timer timer(timeout, &eh);
 
+    if (params.arith_mps_exact()) {
+        run_lar_solver(params, lp_limit, mps_file_name);
+        return;
+    }
+
     std::string fn(mps_file_name);
     lp::mps_reader<double, double> reader(fn);
     reader.set_message_stream(&std::cout); // can be redirected
@@ -25,6 +25,7 @@ void qi_params::updt_params(params_ref const & _p) {
     m_mbqi_max_cexs = p.mbqi_max_cexs();
     m_mbqi_max_cexs_incr = p.mbqi_max_cexs_incr();
     m_mbqi_max_iterations = p.mbqi_max_iterations();
+    m_mbqi_threads = p.mbqi_threads();
     m_mbqi_trace = p.mbqi_trace();
     m_mbqi_force_template = p.mbqi_force_template();
     m_mbqi_id = p.mbqi_id();
@@ -59,6 +60,7 @@ void qi_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_mbqi_max_cexs);
     DISPLAY_PARAM(m_mbqi_max_cexs_incr);
     DISPLAY_PARAM(m_mbqi_max_iterations);
+    DISPLAY_PARAM(m_mbqi_threads);
     DISPLAY_PARAM(m_mbqi_trace);
     DISPLAY_PARAM(m_mbqi_force_template);
     DISPLAY_PARAM(m_mbqi_id);
@@ -48,6 +48,7 @@ struct qi_params {
     unsigned           m_mbqi_max_cexs;
     unsigned           m_mbqi_max_cexs_incr;
     unsigned           m_mbqi_max_iterations;
+    unsigned           m_mbqi_threads;
     bool               m_mbqi_trace;
     unsigned           m_mbqi_force_template;
     const char *       m_mbqi_id;
@@ -96,6 +97,7 @@ struct qi_params {
         m_mbqi_max_cexs(1),
         m_mbqi_max_cexs_incr(1),
         m_mbqi_max_iterations(1000),
+        m_mbqi_threads(1),
         m_mbqi_trace(false),
         m_mbqi_force_template(10),
         m_mbqi_id(nullptr)
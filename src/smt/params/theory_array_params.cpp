@@ -23,6 +23,7 @@ void theory_array_params::updt_params(params_ref const & _p) {
     smt_params_helper p(_p);
     m_array_weak = p.array_weak();
     m_array_extensional = p.array_extensional();
+    m_array_lazy_store_axioms = p.array_lazy_store_axioms();
 }
 
 #define DISPLAY_PARAM(X) out << #X"=" << X << std::endl;
@@ -37,4 +38,5 @@ void theory_array_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_array_always_prop_upward);
     DISPLAY_PARAM(m_array_lazy_ieq);
     DISPLAY_PARAM(m_array_lazy_ieq_delay);
+    DISPLAY_PARAM(m_array_lazy_store_axioms);
 }
@@ -87,7 +87,7 @@ namespace smt {
                 return r;
             }
             else if (d->is_commutative()) {
-                r = TAG(void*, alloc(comm_table, cg_comm_hash(), cg_comm_eq(m_commutativity)), BINARY_COMM);
+                r = TAG(void*, alloc(comm_table, cg_binary_hash(), cg_comm_eq(m_commutativity)), BINARY_COMM);
                 SASSERT(GET_TAG(r) == BINARY_COMM);
                 return r;
             }
@@ -170,8 +170,8 @@ namespace smt {
     void cg_table::display_binary(std::ostream& out, void* t) const {
         binary_table* tb = UNTAG(binary_table*, t);
         out << "b ";
-        for (enode* n : *tb) {
-            out << n->get_owner_id() << " " << cg_binary_hash()(n) << " ";
+        for (cg_binary_key const& k : *tb) {
+            out << k.m_n->get_owner_id() << " " << k.m_hash << " ";
         }
         out << "\n";
     }
@@ -179,8 +179,8 @@ namespace smt {
     void cg_table::display_binary_comm(std::ostream& out, void* t) const {
         comm_table* tb = UNTAG(comm_table*, t);
         out << "bc ";
-        for (enode* n : *tb) {
-            out << n->get_owner_id() << " ";
+        for (cg_binary_key const& k : *tb) {
+            out << k.m_n->get_owner_id() << " ";
         }
         out << "\n";
     }
@@ -188,8 +188,8 @@ namespace smt {
     void cg_table::display_unary(std::ostream& out, void* t) const {
         unary_table* tb = UNTAG(unary_table*, t);
         out << "un ";
-        for (enode* n : *tb) {
-            out << n->get_owner_id() << " ";
+        for (cg_unary_key const& k : *tb) {
+            out << k.m_n->get_owner_id() << " ";
         }
         out << "\n";
     }
@@ -213,16 +213,18 @@ namespace smt {
         void * t = get_table(n); 
         switch (static_cast<table_kind>(GET_TAG(t))) {
         case UNARY:
-            n_prime = UNTAG(unary_table*, t)->insert_if_not_there(n);
+            n_prime = UNTAG(unary_table*, t)->insert_if_not_there(cg_unary_key(n)).m_n;
             return enode_bool_pair(n_prime, false);
-        case BINARY:
-            n_prime = UNTAG(binary_table*, t)->insert_if_not_there(n);
-            TRACE("cg_table", tout << "insert: " << n->get_owner_id() << " " << cg_binary_hash()(n) << " inserted: " << (n == n_prime) << " " << n_prime->get_owner_id() << "\n";
+        case BINARY: {
+            cg_binary_key k(n, false);
+            n_prime = UNTAG(binary_table*, t)->insert_if_not_there(k).m_n;
+            TRACE("cg_table", tout << "insert: " << n->get_owner_id() << " " << k.m_hash << " inserted: " << (n == n_prime) << " " << n_prime->get_owner_id() << "\n";
                   display_binary(tout, t); tout << "contains_ptr: " << contains_ptr(n) << "\n";); 
             return enode_bool_pair(n_prime, false);
+        }
         case BINARY_COMM:
             m_commutativity = false;
-            n_prime = UNTAG(comm_table*, t)->insert_if_not_there(n);
+            n_prime = UNTAG(comm_table*, t)->insert_if_not_there(cg_binary_key(n, true)).m_n;
             return enode_bool_pair(n_prime, m_commutativity);
         default:
             n_prime = UNTAG(table*, t)->insert_if_not_there(n);
@@ -235,14 +237,14 @@ namespace smt {
         void * t = get_table(n); 
         switch (static_cast<table_kind>(GET_TAG(t))) {
         case UNARY:
-            UNTAG(unary_table*, t)->erase(n);
+            UNTAG(unary_table*, t)->erase(cg_unary_key(n));
             break;
         case BINARY:
-            TRACE("cg_table", tout << "erase: " << n->get_owner_id() << " " << cg_binary_hash()(n) << " contains: " << contains_ptr(n) << "\n";);
-            UNTAG(binary_table*, t)->erase(n);
+            TRACE("cg_table", tout << "erase: " << n->get_owner_id() << " " << cg_binary_key(n, false).m_hash << " contains: " << contains_ptr(n) << "\n";);
+            UNTAG(binary_table*, t)->erase(cg_binary_key(n, false));
             break;
         case BINARY_COMM:
-            UNTAG(comm_table*, t)->erase(n);
+            UNTAG(comm_table*, t)->erase(cg_binary_key(n, true));
             break;
         default:
             UNTAG(table*, t)->erase(n);
@@ -33,70 +33,86 @@ namespace smt {
        \brief Congruence table.
     */
     class cg_table {
-        struct cg_unary_hash {
-            unsigned operator()(enode * n) const {
+        /**
+           \brief Entries of the unary and binary tables store the roots of the
+           arguments and the hash code inline. The roots of the arguments of an
+           enode cannot change while it is in the table: the context removes the
+           parents of a class before merging it (see remove_parents_from_cg_table),
+           and reinserts them afterwards. So lookups and rehashing do not need to
+           follow the argument and root pointers of the stored enodes.
+        */
+        struct cg_unary_key {
+            enode *  m_n;
+            enode *  m_r1;
+            unsigned m_hash;
+            cg_unary_key(): m_n(nullptr), m_r1(nullptr), m_hash(0) {}
+            cg_unary_key(enode * n):
+                m_n(n),
+                m_r1(n->get_arg(0)->get_root()),
+                m_hash(m_r1->hash()) {
                 SASSERT(n->get_num_args() == 1);
-                return n->get_arg(0)->get_root()->hash();
             }
         };
 
+        struct cg_unary_hash {
+            unsigned operator()(cg_unary_key const & k) const { return k.m_hash; }
+        };
+
         struct cg_unary_eq {
-            bool operator()(enode * n1, enode * n2) const {
-                SASSERT(n1->get_num_args() == 1);
-                SASSERT(n2->get_num_args() == 1);
-                SASSERT(n1->get_decl() == n2->get_decl());
-                return n1->get_arg(0)->get_root() == n2->get_arg(0)->get_root();
+            bool operator()(cg_unary_key const & k1, cg_unary_key const & k2) const {
+                SASSERT(k1.m_n->get_decl() == k2.m_n->get_decl());
+                return k1.m_r1 == k2.m_r1;
             }
         };
 
-        typedef chashtable<enode *, cg_unary_hash, cg_unary_eq> unary_table;
-        
-        struct cg_binary_hash {
-            unsigned operator()(enode * n) const {
+        typedef chashtable<cg_unary_key, cg_unary_hash, cg_unary_eq> unary_table;
+
+        struct cg_binary_key {
+            enode *  m_n;
+            enode *  m_r1;
+            enode *  m_r2;
+            unsigned m_hash;
+            cg_binary_key(): m_n(nullptr), m_r1(nullptr), m_r2(nullptr), m_hash(0) {}
+            cg_binary_key(enode * n, bool comm):
+                m_n(n),
+                m_r1(n->get_arg(0)->get_root()),
+                m_r2(n->get_arg(1)->get_root()) {
                 SASSERT(n->get_num_args() == 2);
-                return combine_hash(n->get_arg(0)->get_root()->hash(), n->get_arg(1)->get_root()->hash());
+                unsigned h1 = m_r1->hash();
+                unsigned h2 = m_r2->hash();
+                if (comm) {
+                    if (h1 > h2)
+                        std::swap(h1, h2);
+                    m_hash = hash_u((h1 << 16) | (h2 & 0xFFFF));
+                }
+                else {
+                    m_hash = combine_hash(h1, h2);
+                }
             }
         };
 
-        struct cg_binary_eq {
-            bool operator()(enode * n1, enode * n2) const {
-                SASSERT(n1->get_num_args() == 2);
-                SASSERT(n2->get_num_args() == 2);
-                SASSERT(n1->get_decl() == n2->get_decl());
-                return 
-                    n1->get_arg(0)->get_root() == n2->get_arg(0)->get_root() &&
-                    n1->get_arg(1)->get_root() == n2->get_arg(1)->get_root();
-            }
+        struct cg_binary_hash {
+            unsigned operator()(cg_binary_key const & k) const { return k.m_hash; }
         };
 
-        typedef chashtable<enode*, cg_binary_hash, cg_binary_eq> binary_table;
-        
-        struct cg_comm_hash {
-            unsigned operator()(enode * n) const {
-                SASSERT(n->get_num_args() == 2);
-                unsigned h1 = n->get_arg(0)->get_root()->hash();
-                unsigned h2 = n->get_arg(1)->get_root()->hash();
-                if (h1 > h2)
-                    std::swap(h1, h2);
-                return hash_u((h1 << 16) | (h2 & 0xFFFF));
+        struct cg_binary_eq {
+            bool operator()(cg_binary_key const & k1, cg_binary_key const & k2) const {
+                SASSERT(k1.m_n->get_decl() == k2.m_n->get_decl());
+                return k1.m_r1 == k2.m_r1 && k1.m_r2 == k2.m_r2;
             }
         };
+
+        typedef chashtable<cg_binary_key, cg_binary_hash, cg_binary_eq> binary_table;
         
         struct cg_comm_eq {
             bool & m_commutativity;
             cg_comm_eq(bool & c):m_commutativity(c) {}
-            bool operator()(enode * n1, enode * n2) const {
-                SASSERT(n1->get_num_args() == 2);
-                SASSERT(n2->get_num_args() == 2);
-                SASSERT(n1->get_decl() == n2->get_decl());
-                enode * c1_1 = n1->get_arg(0)->get_root();
-                enode * c1_2 = n1->get_arg(1)->get_root();
-                enode * c2_1 = n2->get_arg(0)->get_root();
-                enode * c2_2 = n2->get_arg(1)->get_root();
-                if (c1_1 == c2_1 && c1_2 == c2_2) {
+            bool operator()(cg_binary_key const & k1, cg_binary_key const & k2) const {
+                SASSERT(k1.m_n->get_decl() == k2.m_n->get_decl());
+                if (k1.m_r1 == k2.m_r1 && k1.m_r2 == k2.m_r2) {
                     return true;
                 }
-                if (c1_1 == c2_2 && c1_2 == c2_1) {
+                if (k1.m_r1 == k2.m_r2 && k1.m_r2 == k2.m_r1) {
                     m_commutativity = true;
                     return true;
                 }
@@ -104,7 +120,7 @@ namespace smt {
             }
         };
 
-        typedef chashtable<enode*, cg_comm_hash, cg_comm_eq> comm_table;
+        typedef chashtable<cg_binary_key, cg_binary_hash, cg_comm_eq> comm_table;
 
         struct cg_hash {
             unsigned operator()(enode * n) const;
@@ -154,50 +170,34 @@ namespace smt {
         void erase(enode * n);
 
         bool contains(enode * n) const {
-            SASSERT(n->get_num_args() > 0);
-            void * t = const_cast<cg_table*>(this)->get_table(n); 
-            switch (static_cast<table_kind>(GET_TAG(t))) {
-            case UNARY:
-                return UNTAG(unary_table*, t)->contains(n);
-            case BINARY:
-                return UNTAG(binary_table*, t)->contains(n);
-            case BINARY_COMM:
-                return UNTAG(comm_table*, t)->contains(n);
-            default:
-                return UNTAG(table*, t)->contains(n);
-            }
+            return find(n) != nullptr;
         }
 
         enode * find(enode * n) const {
             SASSERT(n->get_num_args() > 0);
-            enode * r = nullptr;
             void * t = const_cast<cg_table*>(this)->get_table(n); 
             switch (static_cast<table_kind>(GET_TAG(t))) {
-            case UNARY:
-                return UNTAG(unary_table*, t)->find(n, r) ? r : nullptr;
-            case BINARY:
-                return UNTAG(binary_table*, t)->find(n, r) ? r : nullptr;
-            case BINARY_COMM:
-                return UNTAG(comm_table*, t)->find(n, r) ? r : nullptr;
-            default:
+            case UNARY: {
+                cg_unary_key r;
+                return UNTAG(unary_table*, t)->find(cg_unary_key(n), r) ? r.m_n : nullptr;
+            }
+            case BINARY: {
+                cg_binary_key r;
+                return UNTAG(binary_table*, t)->find(cg_binary_key(n, false), r) ? r.m_n : nullptr;
+            }
+            case BINARY_COMM: {
+                cg_binary_key r;
+                return UNTAG(comm_table*, t)->find(cg_binary_key(n, true), r) ? r.m_n : nullptr;
+            }
+            default: {
+                enode * r = nullptr;
                 return UNTAG(table*, t)->find(n, r) ? r : nullptr;
             }
+            }
         }
 
         bool contains_ptr(enode * n) const {
-            enode * r;
-            SASSERT(n->get_num_args() > 0);
-            void * t = const_cast<cg_table*>(this)->get_table(n); 
-            switch (static_cast<table_kind>(GET_TAG(t))) {
-            case UNARY:
-                return UNTAG(unary_table*, t)->find(n, r) && n == r;
-            case BINARY:
-                return UNTAG(binary_table*, t)->find(n, r) && n == r;
-            case BINARY_COMM:
-                return UNTAG(comm_table*, t)->find(n, r) && n == r;
-            default:
-                return UNTAG(table*, t)->find(n, r) && n == r;
-            }
+            return find(n) == n;
         }
 
         void reset();
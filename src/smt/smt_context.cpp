@@ -39,6 +39,7 @@ Revision History:
 #include "smt/smt_model_checker.h"
 #include "smt/smt_model_finder.h"
 #include "smt/smt_parallel.h"
+#include "smt/theory_user_propagator.h"
 
 namespace smt {
 
@@ -66,6 +67,7 @@ namespace smt {
         m_is_auxiliary(false),
         m_par(nullptr),
         m_par_index(0),
+        m_user_propagator(nullptr),
         m_cg_table(m),
         m_is_diseq_tmp(nullptr),
         m_units_to_reassert(m),
@@ -259,7 +261,11 @@ namespace smt {
     }
 
     context * context::mk_fresh(symbol const * l, smt_params * p, params_ref const& pa) {
-        context * new_ctx = alloc(context, m, p ? *p : m_fparams, pa);
+        return mk_fresh(m, l, p, pa);
+    }
+
+    context * context::mk_fresh(ast_manager & dst_m, symbol const * l, smt_params * p, params_ref const& pa) {
+        context * new_ctx = alloc(context, dst_m, p ? *p : m_fparams, pa);
         new_ctx->m_is_auxiliary = true;
         new_ctx->set_logic(l == nullptr ? m_setup.get_logic() : *l);
         copy_plugins(*this, *new_ctx);
@@ -1369,6 +1375,11 @@ namespace smt {
                 propagate_bool_var_enode(v);
             if (inconsistent())
                 return false;
+            if (m_user_propagator && d.is_enode()) {
+                m_user_propagator->new_fixed_eh(v, val == l_true);
+                if (inconsistent())
+                    return false;
+            }
             if (d.is_eq()) {
                 app * n   = to_app(m_bool_var2expr[v]);
                 SASSERT(m.is_eq(n));
@@ -2870,6 +2881,56 @@ namespace smt {
     }
 #endif
 
+    void context::user_propagate_init(
+        void* ctx, 
+        user_propagator::push_eh_t& push_eh,
+        user_propagator::pop_eh_t& pop_eh) {
+        if (m_user_propagator) 
+            throw default_exception("user propagator already initialized");
+        // scopes created before initialization would be popped without
+        // having been pushed with the user.
+        if (m_base_lvl > 0)
+            throw default_exception("user propagator must be initialized before the first push");
+        pop_to_base_lvl();
+        // all theories must be available before terms are registered.
+        setup_context(false);
+        // registered terms have to survive preprocessing. Macro finding is
+        // the only simplification of asserted formulas that eliminates symbols.
+        m_fparams.m_macro_finder = false;
+        m_fparams.m_quasi_macros = false;
+        // a copied context already has a propagator without callbacks.
+        m_user_propagator = static_cast<theory_user_propagator*>(m_theories.get_plugin(m.mk_family_id("user_propagator")));
+        if (!m_user_propagator) {
+            m_user_propagator = alloc(theory_user_propagator, m);
+            register_plugin(m_user_propagator);
+        }
+        m_user_propagator->add(ctx, push_eh, pop_eh);
+    }
+
+    void context::user_propagate_register_fixed(user_propagator::fixed_eh_t& fixed_eh) {
+        if (!m_user_propagator) 
+            throw default_exception("user propagator must be initialized");
+        m_user_propagator->register_fixed(fixed_eh);
+    }
+
+    void context::user_propagate_register_final(user_propagator::final_eh_t& final_eh) {
+        if (!m_user_propagator) 
+            throw default_exception("user propagator must be initialized");
+        m_user_propagator->register_final(final_eh);
+    }
+
+    void context::user_propagate_register_eq(user_propagator::eq_eh_t& eq_eh) {
+        if (!m_user_propagator) 
+            throw default_exception("user propagator must be initialized");
+        m_user_propagator->register_eq(eq_eh);
+    }
+
+    unsigned context::user_propagate_register(expr* e) {
+        if (!m_user_propagator) 
+            throw default_exception("user propagator must be initialized");
+        return m_user_propagator->add_expr(e);
+    }
+
     void context::register_plugin(theory * th) {
         if (m_theories.get_plugin(th->get_family_id()) != nullptr) {
             dealloc(th);
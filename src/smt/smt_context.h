@@ -50,6 +50,7 @@ Revision History:
 #include "util/timer.h"
 #include "util/statistics.h"
 #include "solver/progress_callback.h"
+#include "solver/user_propagator_base.h"
 #include <tuple>
 
 // there is a significant space overhead with allocating 1000+ contexts in
@@ -126,6 +127,7 @@ namespace smt {
         ptr_vector<enode>           m_enodes;
         plugin_manager<theory>      m_theories;     // mapping from theory_id -> theory
         ptr_vector<theory>          m_theory_set;   // set of theories for fast traversal
+        theory_user_propagator*     m_user_propagator; // owned by m_theories
         vector<enode_vector>        m_decl2enodes;  // decl -> enode (for decls with arity > 0)
         enode_vector                m_empty_vector;
         cg_table                    m_cg_table;
@@ -1529,6 +1531,11 @@ namespace smt {
         */
         context * mk_fresh(symbol const * l = nullptr,  smt_params * smtp = nullptr, params_ref const & p = params_ref());
 
+        /**
+           \brief create a fresh context over dst_m with the same theory plugins.
+        */
+        context * mk_fresh(ast_manager & dst_m, symbol const * l, smt_params * smtp, params_ref const & p);
+
         static void copy(context& src, context& dst, bool override_base = false);
 
         /**
@@ -1603,6 +1610,22 @@ namespace smt {
 
         expr_ref_vector get_trail();
 
+        /*
+         * user-propagator
+         */
+        void user_propagate_init(
+            void* ctx, 
+            user_propagator::push_eh_t& push_eh,
+            user_propagator::pop_eh_t& pop_eh);
+
+        void user_propagate_register_fixed(user_propagator::fixed_eh_t& fixed_eh);
+
+        void user_propagate_register_final(user_propagator::final_eh_t& final_eh);
+
+        void user_propagate_register_eq(user_propagator::eq_eh_t& eq_eh);
+
+        unsigned user_propagate_register(expr* e);
+
         void get_model(model_ref & m);
 
         void set_model(model* m) { m_model = m; }
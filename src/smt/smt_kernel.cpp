@@ -155,6 +155,29 @@ namespace smt {
         expr_ref_vector get_trail() {
             return m_kernel.get_trail();
         }
+
+        void user_propagate_init(
+            void* ctx, 
+            user_propagator::push_eh_t& push_eh,
+            user_propagator::pop_eh_t& pop_eh) {
+            m_kernel.user_propagate_init(ctx, push_eh, pop_eh);
+        }
+
+        void user_propagate_register_fixed(user_propagator::fixed_eh_t& fixed_eh) {
+            m_kernel.user_propagate_register_fixed(fixed_eh);
+        }
+
+        void user_propagate_register_final(user_propagator::final_eh_t& final_eh) {
+            m_kernel.user_propagate_register_final(final_eh);
+        }
+
+        void user_propagate_register_eq(user_propagator::eq_eh_t& eq_eh) {
+            m_kernel.user_propagate_register_eq(eq_eh);
+        }
+
+        unsigned user_propagate_register(expr* e) {
+            return m_kernel.user_propagate_register(e);
+        }
         
         failure last_failure() const {
             return m_kernel.get_last_search_failure();
@@ -412,5 +435,28 @@ namespace smt {
         return m_imp->get_trail();
     }
 
+    void kernel::user_propagate_init(
+        void* ctx, 
+        user_propagator::push_eh_t& push_eh,
+        user_propagator::pop_eh_t& pop_eh) {
+        m_imp->user_propagate_init(ctx, push_eh, pop_eh);
+    }
+
+    void kernel::user_propagate_register_fixed(user_propagator::fixed_eh_t& fixed_eh) {
+        m_imp->user_propagate_register_fixed(fixed_eh);
+    }
+
+    void kernel::user_propagate_register_final(user_propagator::final_eh_t& final_eh) {
+        m_imp->user_propagate_register_final(final_eh);
+    }
+
+    void kernel::user_propagate_register_eq(user_propagator::eq_eh_t& eq_eh) {
+        m_imp->user_propagate_register_eq(eq_eh);
+    }
+
+    unsigned kernel::user_propagate_register(expr* e) {
+        return m_imp->user_propagate_register(e);
+    }
+
 
 };
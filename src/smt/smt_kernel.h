@@ -33,6 +33,7 @@ Revision History:
 #include "util/lbool.h"
 #include "util/statistics.h"
 #include "smt/smt_failure.h"
+#include "solver/user_propagator_base.h"
 
 struct smt_params;
 class progress_callback;
@@ -229,6 +230,25 @@ namespace smt {
         */
         expr_ref_vector get_trail();
 
+        /**
+           \brief attach a user propagator and register its callbacks.
+        */
+        void user_propagate_init(
+            void* ctx, 
+            user_propagator::push_eh_t& push_eh,
+            user_propagator::pop_eh_t& pop_eh);
+
+        void user_propagate_register_fixed(user_propagator::fixed_eh_t& fixed_eh);
+
+        void user_propagate_register_final(user_propagator::final_eh_t& final_eh);
+
+        void user_propagate_register_eq(user_propagator::eq_eh_t& eq_eh);
+
+        /**
+           \brief register a term with the user propagator and return its identifier.
+        */
+        unsigned user_propagate_register(expr* e);
+
         /**
            \brief (For debubbing purposes) Prints the state of the kernel
         */
@@ -29,11 +29,14 @@ Revision History:
 #include "ast/ast_pp.h"
 #include "ast/array_decl_plugin.h"
 #include "ast/ast_smt2_pp.h"
+#include "ast/ast_translation.h"
 #include "smt/smt_model_checker.h"
 #include "smt/smt_context.h"
 #include "smt/smt_model_finder.h"
 #include "model/model_pp.h"
 #include <tuple>
+#include <thread>
+#include <mutex>
 
 namespace smt {
 
@@ -56,6 +59,9 @@ namespace smt {
     model_checker::~model_checker() {
         m_aux_context = nullptr; // delete aux context before fparams
         m_fparams = nullptr;
+        m_par_contexts.reset();
+        m_par_fparams.reset();
+        m_par_managers.reset();
     }
 
     quantifier * model_checker::get_flat_quantifier(quantifier * q) {
@@ -141,29 +147,38 @@ namespace smt {
     }
 
     /**
-       \brief Assert in m_aux_context, the constraint
+       \brief Return the constraint
 
          sk = e_1 OR ... OR sk = e_n
 
          where {e_1, ..., e_n} is the universe.
      */
-    void model_checker::restrict_to_universe(expr * sk, obj_hashtable<expr> const & universe) {
+    expr_ref model_checker::restrict_to_universe(expr * sk, obj_hashtable<expr> const & universe) {
         SASSERT(!universe.empty());
         ptr_buffer<expr> eqs;
         for (expr * e : universe) {
             eqs.push_back(m.mk_eq(sk, e));
         }
-        expr_ref fml(m.mk_or(eqs.size(), eqs.c_ptr()), m);
-        m_aux_context->assert_expr(fml);
+        return expr_ref(m.mk_or(eqs.size(), eqs.c_ptr()), m);
     }
 
     /**
-       \brief Assert the negation of q after applying the interpretation in m_curr_model to the uninterpreted symbols in q.
+       \brief Assert in m_aux_context the negation of q after applying the interpretation in m_curr_model.
+    */
+    void model_checker::assert_neg_q_m(quantifier * q, expr_ref_vector & sks) {
+        expr_ref_vector fmls(m);
+        mk_neg_q_m(q, sks, fmls);
+        for (expr* f : fmls) {
+            m_aux_context->assert_expr(f);
+        }
+    }
+
+    /**
+       \brief Collect in fmls the negation of q after applying the interpretation in m_curr_model to the uninterpreted symbols in q.
 
        The variables are replaced by skolem constants. These constants are stored in sks.
     */
-
-    void model_checker::assert_neg_q_m(quantifier * q, expr_ref_vector & sks) {
+    void model_checker::mk_neg_q_m(quantifier * q, expr_ref_vector & sks, expr_ref_vector & fmls) {
         expr_ref tmp(m);
         
         TRACE("model_checker", tout << "curr_model:\n"; model_pp(tout, *m_curr_model););
@@ -182,7 +197,7 @@ namespace smt {
             sks[num_decls - i - 1]        = sk;
             subst_args[num_decls - i - 1] = sk;
             if (m_curr_model->is_finite(s)) {
-                restrict_to_universe(sk, m_curr_model->get_known_universe(s));
+                fmls.push_back(restrict_to_universe(sk, m_curr_model->get_known_universe(s)));
             }
         }
 
@@ -191,7 +206,7 @@ namespace smt {
         expr_ref r(m);
         r = m.mk_not(sk_body);
         TRACE("model_checker", tout << "mk_neg_q_m:\n" << mk_ismt2_pp(r, m) << "\n";);
-        m_aux_context->assert_expr(r);
+        fmls.push_back(r);
     }
 
     bool model_checker::add_instance(quantifier * q, model * cex, expr_ref_vector & sks, bool use_inv) {
@@ -297,8 +312,9 @@ namespace smt {
         return false;
     }
 
-    bool model_checker::add_blocking_clause(model * cex, expr_ref_vector & sks) {
+    bool model_checker::add_blocking_clause(context & ctx, model * cex, expr_ref_vector const & sks) {
         SASSERT(cex != nullptr);
+        ast_manager & m = ctx.get_manager();
         expr_ref_buffer diseqs(m);
         for (expr * sk : sks) {
             func_decl * sk_d = to_app(sk)->get_decl();
@@ -312,7 +328,7 @@ namespace smt {
         expr_ref blocking_clause(m);
         blocking_clause = m.mk_or(diseqs.size(), diseqs.c_ptr());
         TRACE("model_checker", tout << "blocking clause:\n" << mk_ismt2_pp(blocking_clause, m) << "\n";);
-        m_aux_context->assert_expr(blocking_clause);
+        ctx.assert_expr(blocking_clause);
         return true;
     }
 
@@ -364,7 +380,7 @@ namespace smt {
                 break;
             }
             num_new_instances++;
-            if (num_new_instances >= m_max_cexs || !add_blocking_clause(cex.get(), sks)) {
+            if (num_new_instances >= m_max_cexs || !add_blocking_clause(*m_aux_context, cex.get(), sks)) {
                 TRACE("model_checker", tout << "Add blocking clause failed new-instances: " << num_new_instances << " max-cex: " << m_max_cexs << "\n";);
                 // add_blocking_clause failed... stop the search for new counter-examples...
                 break;
@@ -380,6 +396,143 @@ namespace smt {
         return false;
     }
 
+    /**
+       \brief Check a quantifier on an auxiliary context of the pool.
+       Runs on a worker thread and only accesses the manager of ctx.
+       Collects the complete counter-example and up to m_max_cexs
+       counter-examples restricted to the instantiation sets.
+    */
+    void model_checker::check_par(context & ctx, par_check & pc) {
+        if (pc.m_fmls.empty()) {
+            // the quantifier could not be evaluated in the model.
+            pc.m_result = l_true;
+            return;
+        }
+        scoped_ctx_push _push(&ctx);
+        for (expr* f : pc.m_fmls) {
+            ctx.assert_expr(f);
+        }
+        pc.m_result = ctx.check(0, nullptr, false);
+        if (pc.m_result != l_true)
+            return;
+        ctx.get_model(pc.m_complete_cex);
+        for (expr* f : pc.m_restrict) {
+            ctx.assert_expr(f);
+        }
+        while (ctx.check(0, nullptr, false) == l_true) {
+            model_ref cex;
+            ctx.get_model(cex);
+            pc.m_cexs.push_back(cex.get());
+            if (pc.m_cexs.size() >= m_max_cexs || !add_blocking_clause(ctx, cex.get(), pc.m_wsks)) {
+                break;
+            }
+        }
+    }
+
+    /**
+       \brief Create instances from the counter-examples found by check_par.
+       Return true if the quantifier is satisfied by m_curr_model.
+    */
+    bool model_checker::check(par_check & pc) {
+        TRACE("model_checker", tout << "[parallel] model-checker result: " << to_sat_str(pc.m_result) << " cexs: " << pc.m_cexs.size() << "\n";);
+        if (pc.m_result != l_true) {
+            return pc.m_result == l_false;
+        }
+        unsigned num_new_instances = 0;
+        for (model* cex : pc.m_cexs) {
+            if (!add_instance(pc.m_q, cex, pc.m_sks, true)) {
+                break;
+            }
+            num_new_instances++;
+        }
+        if (num_new_instances == 0) {
+            add_instance(pc.m_q, pc.m_complete_cex.get(), pc.m_sks, false);
+        }
+        return false;
+    }
+
+    /**
+       \brief Check the quantifiers qs that are not recursive function definitions
+       on the auxiliary contexts of the pool.
+
+       Quantifiers are assigned to contexts round-robin, so the counter-examples
+       do not depend on thread scheduling. The negated quantifiers are built and
+       the models translated back on the calling thread. pcs[i] is the check
+       of qs[i], or null if qs[i] is left to the sequential check.
+    */
+    void model_checker::run_par_checks(ptr_vector<quantifier> const & qs, scoped_ptr_vector<par_check> & pcs) {
+        unsigned num_threads = std::min(m_params.m_mbqi_threads, qs.size());
+        if (num_threads <= 1)
+            return;
+        init_par_contexts(num_threads);
+        scoped_limits sl(m.limit());
+        scoped_ptr_vector<ast_translation> trs;
+        for (unsigned i = 0; i < num_threads; ++i) {
+            ast_manager& wm = *m_par_managers[i];
+            wm.limit().reset_cancel();
+            sl.push_child(&wm.limit());
+            trs.push_back(alloc(ast_translation, m, wm, false));
+        }
+
+        unsigned worker = 0;
+        for (quantifier * q : qs) {
+            if (m.is_rec_fun_def(q)) {
+                pcs.push_back(nullptr);
+                continue;
+            }
+            ast_translation& tr = *trs[worker];
+            par_check* pc = alloc(par_check, q, worker, m, *m_par_managers[worker]);
+            pcs.push_back(pc);
+            expr_ref_vector fmls(m), restrict(m);
+            mk_neg_q_m(get_flat_quantifier(q), pc->m_sks, fmls);
+            if (!pc->m_sks.empty()) {
+                m_model_finder.restrict_sks_to_inst_set(q, pc->m_sks, restrict);
+            }
+            for (expr* e : pc->m_sks) pc->m_wsks.push_back(tr(e));
+            for (expr* e : fmls) pc->m_fmls.push_back(tr(e));
+            for (expr* e : restrict) pc->m_restrict.push_back(tr(e));
+            worker = (worker + 1) % num_threads;
+        }
+
+        std::mutex mux;
+        std::string ex_msg;
+        bool has_ex = false;
+        vector<std::thread> threads(num_threads);
+        for (unsigned i = 0; i < num_threads; ++i) {
+            threads[i] = std::thread([&, i]() {
+                try {
+                    for (par_check* pc : pcs) {
+                        if (pc && pc->m_worker == i) {
+                            check_par(*m_par_contexts[i], *pc);
+                        }
+                    }
+                }
+                catch (z3_exception & ex) {
+                    std::lock_guard<std::mutex> lock(mux);
+                    has_ex = true;
+                    ex_msg = ex.msg();
+                }
+            });
+        }
+        for (auto & th : threads) {
+            th.join();
+        }
+        if (has_ex) {
+            throw default_exception(std::move(ex_msg));
+        }
+
+        for (par_check* pc : pcs) {
+            if (!pc) continue;
+            ast_translation tr(*m_par_managers[pc->m_worker], m, false);
+            if (pc->m_complete_cex) {
+                pc->m_complete_cex = pc->m_complete_cex->translate(tr);
+            }
+            for (unsigned j = 0; j < pc->m_cexs.size(); ++j) {
+                pc->m_cexs.set(j, pc->m_cexs[j]->translate(tr));
+            }
+        }
+    }
+
     bool model_checker::check_rec_fun(quantifier* q, bool strict_rec_fun) {
         TRACE("model_checker", tout << mk_pp(q, m) << "\n";);
         SASSERT(q->get_num_patterns() == 2); // first pattern is the function, second is the body.
@@ -425,6 +578,20 @@ namespace smt {
         }
     }
 
+    void model_checker::init_par_contexts(unsigned num_threads) {
+        symbol logic;
+        params_ref p;
+        p.set_bool("arith.dump_lemmas", false);
+        while (m_par_contexts.size() < num_threads) {
+            ast_manager * wm = alloc(ast_manager, m, true);
+            m_par_managers.push_back(wm);
+            smt_params * fparams = alloc(smt_params, *m_fparams);
+            fparams->m_array_fake_support = true;
+            m_par_fparams.push_back(fparams);
+            m_par_contexts.push_back(m_context->mk_fresh(*wm, &logic, fparams, p));
+        }
+    }
+
     bool model_checker::check(proto_model * md, obj_map<enode, app *> const & root2value) {
         SASSERT(md != nullptr);
 
@@ -533,13 +700,20 @@ namespace smt {
     //
 
     void model_checker::check_quantifiers(bool strict_rec_fun, bool& found_relevant, unsigned& num_failures) {
+        ptr_vector<quantifier> qs;
         for (quantifier * q : *m_qm) {
-            if (!(m_qm->mbqi_enabled(q) &&
-                  m_context->is_relevant(q) &&
-                  m_context->get_assignment(q) == l_true &&
-                  (!m_context->get_fparams().m_ematching || !m.is_lambda_def(q)))) {
-                continue;
+            if (m_qm->mbqi_enabled(q) &&
+                m_context->is_relevant(q) &&
+                m_context->get_assignment(q) == l_true &&
+                (!m_context->get_fparams().m_ematching || !m.is_lambda_def(q))) {
+                qs.push_back(q);
             }
+        }
+        scoped_ptr_vector<par_check> pcs;
+        run_par_checks(qs, pcs);
+        for (unsigned i = 0; i < qs.size(); ++i) {
+            quantifier * q = qs[i];
+            par_check * pc = i < pcs.size() ? pcs[i] : nullptr;
 
             TRACE("model_checker",
                   tout << "Check: " << mk_pp(q, m) << "\n";
@@ -556,7 +730,7 @@ namespace smt {
                     num_failures++;
                 }
             }
-            else if (!check(q)) {
+            else if (pc ? !check(*pc) : !check(q)) {
                 if (m_params.m_mbqi_trace || get_verbosity_level() >= 5) {
                     IF_VERBOSE(0, verbose_stream() << "(smt.mbqi :failed " << q->get_qid() << ")\n");
                 }
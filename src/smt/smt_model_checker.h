@@ -22,9 +22,12 @@ Revision History:
 #define SMT_MODEL_CHECKER_H_
 
 #include "util/obj_hashtable.h"
+#include "util/scoped_ptr_vector.h"
+#include "util/lbool.h"
 #include "ast/ast.h"
 #include "ast/array_decl_plugin.h"
 #include "ast/normal_forms/defined_names.h"
+#include "model/model.h"
 #include "smt/params/qi_params.h"
 #include "smt/params/smt_params.h"
 
@@ -56,16 +59,45 @@ namespace smt {
         obj_map<expr, expr *>                       m_value2expr;
         expr_ref_vector                             m_fresh_exprs;
 
+        // auxiliary contexts, each with its own manager, used when mbqi.threads > 1.
+        scoped_ptr_vector<ast_manager>              m_par_managers;
+        scoped_ptr_vector<smt_params>               m_par_fparams;
+        scoped_ptr_vector<context>                  m_par_contexts;
+
+        /**
+           \brief check of a single quantifier on an auxiliary context of the pool.
+           Formulas and models live in the manager of that context until the
+           results are translated back.
+        */
+        struct par_check {
+            quantifier *       m_q;
+            unsigned           m_worker;
+            expr_ref_vector    m_sks;      // skolem constants of the flat quantifier.
+            expr_ref_vector    m_wsks;     // m_sks translated to the worker.
+            expr_ref_vector    m_fmls;     // negation of the quantifier in the current model.
+            expr_ref_vector    m_restrict; // restriction of m_wsks to the instantiation sets.
+            lbool              m_result;
+            model_ref          m_complete_cex;
+            sref_vector<model> m_cexs;
+            par_check(quantifier * q, unsigned worker, ast_manager & m, ast_manager & wm):
+                m_q(q), m_worker(worker), m_sks(m), m_wsks(wm), m_fmls(wm), m_restrict(wm), m_result(l_undef) {}
+        };
+
         friend class instantiation_set;
 
         void init_aux_context();
+        void init_par_contexts(unsigned num_threads);
+        void run_par_checks(ptr_vector<quantifier> const & qs, scoped_ptr_vector<par_check> & pcs);
+        void check_par(context & ctx, par_check & pc);
+        bool check(par_check & pc);
         void init_value2expr();
         expr * get_term_from_ctx(expr * val);
         expr * get_type_compatible_term(expr * val);
         expr_ref replace_value_from_ctx(expr * e);
-        void restrict_to_universe(expr * sk, obj_hashtable<expr> const & universe);
+        expr_ref restrict_to_universe(expr * sk, obj_hashtable<expr> const & universe);
+        void mk_neg_q_m(quantifier * q, expr_ref_vector & sks, expr_ref_vector & fmls);
         void assert_neg_q_m(quantifier * q, expr_ref_vector & sks);
-        bool add_blocking_clause(model * cex, expr_ref_vector & sks);
+        static bool add_blocking_clause(context & ctx, model * cex, expr_ref_vector const & sks);
         bool check(quantifier * q);
         bool check_rec_fun(quantifier* q, bool strict_rec_fun);
         bool has_rec_under_quantifiers();
@@ -3379,6 +3379,18 @@ namespace smt {
        Return true if something was asserted.
     */
     bool model_finder::restrict_sks_to_inst_set(context * aux_ctx, quantifier * q, expr_ref_vector const & sks) {
+        expr_ref_vector cnstrs(m);
+        if (!restrict_sks_to_inst_set(q, sks, cnstrs))
+            return false;
+        for (expr* c : cnstrs)
+            aux_ctx->assert_expr(c);
+        return true;
+    }
+
+    /**
+       \brief Collect the constraints restricting sks to the instantiation sets of q.
+    */
+    bool model_finder::restrict_sks_to_inst_set(quantifier * q, expr_ref_vector const & sks, expr_ref_vector & cnstrs) {
         // Note: we currently add instances of q instead of flat_q.
         // If the user wants instances of flat_q, it should use PULL_NESTED_QUANTIFIERS=true. This option
         // will guarantee that q == flat_q.
@@ -3405,7 +3417,7 @@ namespace smt {
             expr_ref new_cnstr(m);
             new_cnstr = m.mk_or(eqs.size(), eqs.c_ptr());
             TRACE("model_finder", tout << "assert_restriction:\n" << mk_pp(new_cnstr, m) << "\n";);
-            aux_ctx->assert_expr(new_cnstr);
+            cnstrs.push_back(new_cnstr);
             asserted_something = true;
         }
         return asserted_something;
@@ -203,6 +203,29 @@ namespace {
             return m_context.get_trail();
         }
 
+        void user_propagate_init(
+            void* ctx, 
+            user_propagator::push_eh_t& push_eh,
+            user_propagator::pop_eh_t& pop_eh) override {
+            m_context.user_propagate_init(ctx, push_eh, pop_eh);
+        }
+
+        void user_propagate_register_fixed(user_propagator::fixed_eh_t& fixed_eh) override {
+            m_context.user_propagate_register_fixed(fixed_eh);
+        }
+
+        void user_propagate_register_final(user_propagator::final_eh_t& final_eh) override {
+            m_context.user_propagate_register_final(final_eh);
+        }
+
+        void user_propagate_register_eq(user_propagator::eq_eh_t& eq_eh) override {
+            m_context.user_propagate_register_eq(eq_eh);
+        }
+
+        unsigned user_propagate_register(expr* e) override {
+            return m_context.user_propagate_register(e);
+        }
+
         struct scoped_minimize_core {
             smt_solver& s;
             expr_ref_vector m_assumptions;
@@ -51,6 +51,7 @@ namespace smt {
     class context;
 
     class theory;
+    class theory_user_propagator;
 
     class justification;
 
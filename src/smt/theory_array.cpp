@@ -366,6 +366,8 @@ namespace smt {
     final_check_status theory_array::final_check_eh() {
         m_final_check_idx++;
         final_check_status r = FC_DONE;
+        if (assert_lazy_store_axioms() == FC_CONTINUE)
+            return FC_CONTINUE;
         if (m_params.m_array_lazy_ieq) {
             // Delay the creation of interface equalities...  The
             // motivation is too give other theories and quantifier
@@ -396,6 +398,10 @@ namespace smt {
                     r = assert_delayed_axioms();
             }
         }
+        // assert_delayed_axioms and the interface equalities can queue new
+        // lazy store axioms; they must be checked before the model is accepted.
+        if (r != FC_CONTINUE && assert_lazy_store_axioms() == FC_CONTINUE)
+            r = FC_CONTINUE;
         bool should_giveup = m_found_unsupported_op || has_propagate_up_trail();
         if (r == FC_DONE && should_giveup && !get_context().get_fparams().m_array_fake_support) 
             r = FC_GIVEUP;
@@ -474,6 +480,7 @@ namespace smt {
         st.update("array ax1", m_stats.m_num_axiom1);
         st.update("array ax2", m_stats.m_num_axiom2a);
         st.update("array exp ax2", m_stats.m_num_axiom2b);
+        st.update("array lazy ax2", m_num_axiom2_lazy);
         st.update("array ext ax", m_stats.m_num_extensionality);
         st.update("array splits", m_stats.m_num_eq_splits);
     }
@@ -29,7 +29,10 @@ namespace smt {
     theory_array_base::theory_array_base(ast_manager & m):
         theory(m.mk_family_id("array")),
         m_found_unsupported_op(false),
-        m_array_weak_head(0)
+        m_array_weak_head(0),
+        m_axiom2_delayed_head(0),
+        m_axiom2_hot_pinned(m),
+        m_num_axiom2_lazy(0)
     {
     }
 
@@ -212,6 +215,13 @@ namespace smt {
         if (i == num_args)
             return false;
         if (get_context().add_fingerprint(store, store->get_owner_id(), select->get_num_args() - 1, select->get_args() + 1)) {
+            if (get_context().get_fparams().m_array_lazy_store_axioms &&
+                !m_axiom2_hot.contains(std::make_pair(store->get_owner(), select->get_owner()))) {
+                TRACE("array", tout << "delaying axiom2 to final check\n";);
+                get_context().push_trail(push_back_vector<context, enode_pair_vector>(m_axiom2_delayed));
+                m_axiom2_delayed.push_back(std::make_pair(store, select));
+                return false;
+            }
             TRACE("array", tout << "adding axiom2 to todo queue\n";);
             m_axiom2_todo.push_back(std::make_pair(store, select)); 
             return true;
@@ -220,6 +230,65 @@ namespace smt {
         return false;
     }
 
+    /**
+       \brief Return true if the current assignment satisfies the axiom for (store, select)
+       without instantiating it: either every index of select is already equal to the
+       corresponding index of store, or select(store, j) and select(a, j) both exist and
+       are already equal. The check is on the axiom instance, not on select itself: for
+       pairs found by upward propagation select is select(a', j) with a' = a, which is
+       trivially equal to select(a, j).
+    */
+    bool theory_array_base::is_axiom2_satisfied(enode * store, enode * select) {
+        unsigned num_args = select->get_num_args();
+        bool all_eq = true;
+        for (unsigned i = 1; all_eq && i < num_args; i++)
+            all_eq = store->get_arg(i)->get_root() == select->get_arg(i)->get_root();
+        if (all_eq)
+            return true;
+        context & ctx = get_context();
+        ptr_buffer<enode> args;
+        args.push_back(store);
+        for (unsigned i = 1; i < num_args; i++) 
+            args.push_back(select->get_arg(i));
+        enode * sel1 = ctx.get_enode_eq_to(select->get_decl(), args.size(), args.c_ptr());
+        if (!sel1)
+            return false;
+        args[0] = store->get_arg(0);
+        enode * sel2 = ctx.get_enode_eq_to(select->get_decl(), args.size(), args.c_ptr());
+        return sel2 && sel2->get_root() == sel1->get_root();
+    }
+
+    /**
+       \brief Instantiate the delayed read-over-write axioms that are violated
+       by the current assignment. Pairs are checked once per scope: merges can only
+       turn a satisfied pair into another satisfied pair, and backtracking restores the head.
+       Selects created by an instantiation are delayed in turn and handled by the same loop.
+    */
+    final_check_status theory_array_base::assert_lazy_store_axioms() {
+        if (m_axiom2_delayed_head == m_axiom2_delayed.size())
+            return FC_DONE;
+        context & ctx = get_context();
+        final_check_status r = FC_DONE;
+        ctx.push_trail(value_trail<context, unsigned>(m_axiom2_delayed_head));
+        for (; m_axiom2_delayed_head < m_axiom2_delayed.size() && !ctx.inconsistent(); ++m_axiom2_delayed_head) {
+            enode * store  = m_axiom2_delayed[m_axiom2_delayed_head].first;
+            enode * select = m_axiom2_delayed[m_axiom2_delayed_head].second;
+            if (is_axiom2_satisfied(store, select))
+                continue;
+            TRACE("array", tout << "lazy axiom2: #" << store->get_owner_id() << " #" << select->get_owner_id() << "\n";);
+            std::pair<expr*, expr*> key(store->get_owner(), select->get_owner());
+            if (!m_axiom2_hot.contains(key)) {
+                m_axiom2_hot.insert(key);
+                m_axiom2_hot_pinned.push_back(key.first);
+                m_axiom2_hot_pinned.push_back(key.second);
+            }
+            m_num_axiom2_lazy++;
+            assert_store_axiom2_core(store, select);
+            r = FC_CONTINUE;
+        }
+        return r;
+    }
+
  
 
 
@@ -616,6 +685,10 @@ namespace smt {
 
     void theory_array_base::reset_eh() {
         reset_queues();
+        m_axiom2_delayed.reset();
+        m_axiom2_delayed_head = 0;
+        m_axiom2_hot.reset();
+        m_axiom2_hot_pinned.reset();
         pop_scope_eh(0);
         theory::reset_eh();
     }
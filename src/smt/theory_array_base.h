@@ -19,6 +19,7 @@ Revision History:
 #ifndef THEORY_ARRAY_BASE_H_
 #define THEORY_ARRAY_BASE_H_
 
+#include "util/obj_pair_hashtable.h"
 #include "smt/smt_theory.h"
 #include "smt/theory_array_bapa.h"
 #include "ast/array_decl_plugin.h"
@@ -83,6 +84,25 @@ namespace smt {
         void assert_store_axiom1(enode * n) { m_axiom1_todo.push_back(n); }
         bool assert_store_axiom2(enode * store, enode * select);
 
+        // --------------------------------------------------
+        // Lazy read-over-write axioms
+        //
+        // With array.lazy_store_axioms, the axiom
+        //    i = j or select(store(a, i, v), j) = select(a, j)
+        // is not instantiated during propagation. The pair is recorded
+        // and checked at final check, where the axiom is only instantiated
+        // if the current assignment does not already satisfy it.
+        // Pairs that had to be instantiated are remembered across scopes
+        // and instantiated eagerly when they reappear.
+        // --------------------------------------------------
+        enode_pair_vector                   m_axiom2_delayed;
+        unsigned                            m_axiom2_delayed_head;
+        obj_pair_hashtable<expr, expr>      m_axiom2_hot;
+        expr_ref_vector                     m_axiom2_hot_pinned;
+        unsigned                            m_num_axiom2_lazy;
+        bool is_axiom2_satisfied(enode * store, enode * select);
+        final_check_status assert_lazy_store_axioms();
+
         void assert_extensionality_core(enode * a1, enode * a2);
         bool assert_extensionality(enode * a1, enode * a2);
 
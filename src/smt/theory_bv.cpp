@@ -895,6 +895,10 @@ namespace smt {
         if (approximate_term(term)) {
             return false;
         }
+        if (should_delay(term)) {
+            internalize_delayed(term);
+            return true;
+        }
         switch (term->get_decl_kind()) {
         case OP_BV_NUM:         internalize_num(term); return true;
         case OP_BADD:           internalize_add(term); return true;
@@ -1139,6 +1143,173 @@ namespace smt {
         return false;
     }
 
+    //
+    // Multiplication, unsigned division and remainder produce large circuits.
+    // When bv.delay is set, these terms only get fresh bits when they are
+    // internalized. Their semantics is enforced during final check, first by
+    // up to bv.delay.lemmas value lemmas for the assignment of the arguments,
+    // and then by bit-blasting the term if its value keeps being violated.
+    // The lemma count lives next to the term in m_delayed and is popped with it.
+    //
+    bool theory_bv::should_delay(app * n) const {
+        if (!m_params.m_bv_delay || n->get_num_args() != 2) {
+            return false;
+        }
+        switch (n->get_decl_kind()) {
+        case OP_BMUL:
+        case OP_BUDIV_I:
+        case OP_BUREM_I:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    void theory_bv::internalize_delayed(app * n) {
+        SASSERT(!get_context().e_internalized(n));
+        SASSERT(n->get_num_args() == 2);
+        context & ctx = get_context();
+        process_args(n);
+        enode * e    = mk_enode(n);
+        theory_var v = e->get_th_var(get_id());
+        get_arg_var(e, 0);
+        get_arg_var(e, 1);
+        mk_bits(v);
+        ctx.push_trail(push_back_vector<context, ptr_vector<app>>(m_delayed));
+        ctx.push_trail(push_back_vector<context, unsigned_vector>(m_delayed_lemmas));
+        m_delayed.push_back(n);
+        m_delayed_lemmas.push_back(0);
+        TRACE("bv", tout << "delayed: " << mk_bounded_pp(n, get_manager()) << "\n";);
+    }
+
+    bool theory_bv::eval_delayed(app * n, numeral const & v1, numeral const & v2, numeral & r) const {
+        rational p = rational::power_of_two(get_bv_size(n));
+        switch (n->get_decl_kind()) {
+        case OP_BMUL:
+            r = mod(v1 * v2, p);
+            return true;
+        case OP_BUDIV_I:
+            // the bit-blaster uses the hardware interpretation for division by zero.
+            r = v2.is_zero() ? p - rational(1) : div(v1, v2);
+            return true;
+        case OP_BUREM_I:
+            r = v2.is_zero() ? v1 : mod(v1, v2);
+            return true;
+        default:
+            UNREACHABLE();
+            return false;
+        }
+    }
+
+    /**
+       \brief Return true if the current assignment to the bits of the delayed
+       term n = m_delayed[idx] and its arguments is consistent with the
+       semantics of n. Otherwise, add a lemma that blocks the assignment and
+       return false.
+    */
+    bool theory_bv::check_delayed(unsigned idx) {
+        context & ctx = get_context();
+        app * n       = m_delayed[idx];
+        if (!ctx.is_relevant(n)) {
+            return true;
+        }
+        enode * e     = ctx.get_enode(n);
+        theory_var v  = e->get_th_var(get_id());
+        theory_var v1 = get_arg(e, 0)->get_th_var(get_id());
+        theory_var v2 = get_arg(e, 1)->get_th_var(get_id());
+        numeral val, val1, val2, r;
+        if (v == null_theory_var || v1 == null_theory_var || v2 == null_theory_var ||
+            !get_fixed_value(v, val) || !get_fixed_value(v1, val1) || !get_fixed_value(v2, val2)) {
+            return true;
+        }
+        VERIFY(eval_delayed(n, val1, val2, r));
+        if (val == r) {
+            return true;
+        }
+        TRACE("bv", tout << "violated: " << mk_bounded_pp(n, get_manager()) << " " << val1 << " " << val2 << " " << val << " != " << r << "\n";);
+        // value lemmas are cheap, but a term whose semantics keeps being violated
+        // is bit-blasted to avoid enumerating the assignments of its arguments.
+        if (m_delayed_lemmas[idx] < m_params.m_bv_delay_lemmas) {
+            ++m_delayed_lemmas[idx];
+            add_delayed_value_lemma(n, val1, val2, r);
+        }
+        else {
+            m_stats.m_num_delay_blast++;
+            blast_delayed(n);
+        }
+        return false;
+    }
+
+    void theory_bv::add_delayed_value_lemma(app * n, numeral const & v1, numeral const & v2, numeral const & r) {
+        ast_manager & m = get_manager();
+        context & ctx   = get_context();
+        unsigned sz     = get_bv_size(n);
+        expr_ref c1(m_util.mk_numeral(v1, sz), m);
+        expr_ref c2(m_util.mk_numeral(v2, sz), m);
+        expr_ref c(m_util.mk_numeral(r, sz), m);
+        literal lits[3] = { ~mk_eq(n->get_arg(0), c1, false), ~mk_eq(n->get_arg(1), c2, false), mk_eq(n, c, false) };
+        for (literal l : lits) {
+            ctx.mark_as_relevant(l);
+        }
+        m_stats.m_num_delay_lemmas++;
+        ctx.mk_th_axiom(get_id(), 3, lits);
+    }
+
+    /**
+       \brief The circuit of a delayed term is removed with the scope it was
+       created in. Instead of waiting for final check to detect the violation
+       again, the term is queued and blasted again by propagate at the level
+       the search backtracked to. After a restart this is the base level, so
+       the circuit eventually persists.
+    */
+    class blast_delayed_trail : public trail<context> {
+        theory_bv & m_th;
+        app *       m_term;
+    public:
+        blast_delayed_trail(theory_bv & th, app * n): m_th(th), m_term(n) {}
+        void undo(context & ctx) override {
+            m_th.m_delayed_blasted.erase(m_term);
+            m_th.m_delayed_reblast.push_back(m_term);
+        }
+    };
+
+    void theory_bv::blast_delayed(app * n) {
+        ast_manager & m = get_manager();
+        context & ctx   = get_context();
+        TRACE("bv", tout << "blast: " << mk_bounded_pp(n, m) << "\n";);
+        ctx.push_trail(blast_delayed_trail(*this, n));
+        m_delayed_blasted.insert(n);
+        enode * e = ctx.get_enode(n);
+        expr_ref_vector arg1_bits(m), arg2_bits(m), bits(m);
+        get_arg_bits(e, 0, arg1_bits);
+        get_arg_bits(e, 1, arg2_bits);
+        SASSERT(arg1_bits.size() == arg2_bits.size());
+        switch (n->get_decl_kind()) {
+        case OP_BMUL:
+            m_bb.mk_multiplier(arg1_bits.size(), arg1_bits.c_ptr(), arg2_bits.c_ptr(), bits);
+            break;
+        case OP_BUDIV_I:
+            m_bb.mk_udiv(arg1_bits.size(), arg1_bits.c_ptr(), arg2_bits.c_ptr(), bits);
+            break;
+        case OP_BUREM_I:
+            m_bb.mk_urem(arg1_bits.size(), arg1_bits.c_ptr(), arg2_bits.c_ptr(), bits);
+            break;
+        default:
+            UNREACHABLE();
+        }
+        literal_vector n_bits(m_bits[e->get_th_var(get_id())]);
+        SASSERT(n_bits.size() == bits.size());
+        for (unsigned i = 0; i < n_bits.size(); ++i) {
+            expr_ref s_bit(m);
+            simplify_bit(bits.get(i), s_bit);
+            ctx.internalize(s_bit, true);
+            literal l = ctx.get_literal(s_bit);
+            ctx.mark_as_relevant(l);
+            ctx.mk_th_axiom(get_id(), ~n_bits[i], l);
+            ctx.mk_th_axiom(get_id(), n_bits[i], ~l);
+        }
+    }
+
     void theory_bv::apply_sort_cnstr(enode * n, sort * s) {
         if (!is_attached_to_var(n) && !approximate_term(n->get_owner())) {
             mk_bits(mk_var(n));
@@ -1467,6 +1638,15 @@ namespace smt {
         if (m_approximates_large_bvs) {
             return FC_GIVEUP;
         }
+        bool ok = true;
+        for (unsigned i = 0; i < m_delayed.size(); ++i) {
+            if (!m_delayed_blasted.contains(m_delayed[i]) && !check_delayed(i)) {
+                ok = false;
+            }
+        }
+        if (!ok) {
+            return FC_CONTINUE;
+        }
         return FC_DONE;
     }
 
@@ -1474,6 +1654,7 @@ namespace smt {
         pop_scope_eh(m_trail_stack.get_num_scopes());
         m_bool_var2atom.reset();
         m_fixed_var_table.reset();
+        m_delayed_reblast.reset();
         theory::reset_eh();
     }
 
@@ -1500,7 +1681,8 @@ namespace smt {
         m_bb(m, bb_params),
         m_trail_stack(*this),
         m_find(*this),
-        m_approximates_large_bvs(false) {
+        m_approximates_large_bvs(false),
+        m_delayed_reblast(m) {
         memset(m_eq_activity, 0, sizeof(m_eq_activity));
         memset(m_diseq_activity, 0, sizeof(m_diseq_activity));
     }
@@ -1627,6 +1809,18 @@ namespace smt {
     }
 
     void theory_bv::propagate() {
+        if (!m_delayed_reblast.empty()) {
+            context & ctx = get_context();
+            app_ref_vector reblast(get_manager());
+            reblast.swap(m_delayed_reblast);
+            for (app * n : reblast) {
+                // the term itself may have been removed by the same pop.
+                if (ctx.e_internalized(n) && !m_delayed_blasted.contains(n)) {
+                    m_stats.m_num_delay_reblast++;
+                    blast_delayed(n);
+                }
+            }
+        }
         unsigned sz = m_replay_diseq.size();
         if (sz > 0) {
             for (unsigned i = 0; i < sz; ++i) {
@@ -1800,6 +1994,9 @@ namespace smt {
         st.update("bv bit2core", m_stats.m_num_bit2core);
         st.update("bv->core eq", m_stats.m_num_th2core_eq);
         st.update("bv dynamic eqs", m_stats.m_num_eq_dynamic);
+        st.update("bv delay lemmas", m_stats.m_num_delay_lemmas);
+        st.update("bv delay blast", m_stats.m_num_delay_blast);
+        st.update("bv delay reblast", m_stats.m_num_delay_reblast);
     }
 
     bool theory_bv::check_assignment(theory_var v) {
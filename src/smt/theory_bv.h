@@ -22,6 +22,7 @@ Revision History:
 #include "ast/rewriter/bit_blaster/bit_blaster.h"
 #include "util/trail.h"
 #include "util/union_find.h"
+#include "util/bit_vector.h"
 #include "ast/arith_decl_plugin.h"
 #include "model/numeral_factory.h"
 #include "smt/smt_theory.h"
@@ -32,6 +33,7 @@ namespace smt {
     struct theory_bv_stats {
         unsigned   m_num_diseq_static, m_num_diseq_dynamic, m_num_bit2core, m_num_th2core_eq, m_num_conflicts;
         unsigned   m_num_eq_dynamic;
+        unsigned   m_num_delay_lemmas, m_num_delay_blast, m_num_delay_reblast;
         void reset() { memset(this, 0, sizeof(theory_bv_stats)); }
         theory_bv_stats() { reset(); }
     };
@@ -135,6 +137,11 @@ namespace smt {
         svector<var_pos>         m_prop_queue;
         bool                     m_approximates_large_bvs;
 
+        ptr_vector<app>          m_delayed;          // terms whose bit-blasting is delayed (bv.delay)
+        obj_hashtable<app>       m_delayed_blasted;  // delayed terms that have been bit-blasted in the current scope
+        app_ref_vector           m_delayed_reblast;  // delayed terms whose bit-blasting was undone by backtracking
+        unsigned_vector          m_delayed_lemmas;   // per entry of m_delayed, number of value lemmas created for it
+
         theory_var find(theory_var v) const { return m_find.find(v); }
         theory_var next(theory_var v) const { return m_find.next(v); }
         bool is_root(theory_var v) const { return m_find.is_root(v); }
@@ -213,6 +220,14 @@ namespace smt {
 
         bool approximate_term(app* n);
 
+        bool should_delay(app * n) const;
+        void internalize_delayed(app * n);
+        bool check_delayed(unsigned idx);
+        bool eval_delayed(app * n, numeral const & v1, numeral const & v2, numeral & r) const;
+        void add_delayed_value_lemma(app * n, numeral const & v1, numeral const & v2, numeral const & r);
+        void blast_delayed(app * n);
+
+        friend class blast_delayed_trail;
         template<bool Signed>
         void internalize_le(app * atom);
         bool internalize_xor3(app * n, bool gate_ctx);
@@ -241,7 +256,7 @@ namespace smt {
         bool include_func_interp(func_decl* f) override;
         svector<theory_var>   m_merge_aux[2]; //!< auxiliary vector used in merge_zero_one_bits
         bool merge_zero_one_bits(theory_var r1, theory_var r2);
-        bool can_propagate() override { return !m_replay_diseq.empty(); }
+        bool can_propagate() override { return !m_replay_diseq.empty() || !m_delayed_reblast.empty(); }
         void propagate() override;
 
         // -----------------------------------
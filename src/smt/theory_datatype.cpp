@@ -72,6 +72,11 @@ namespace smt {
         m_stack.push_back(std::make_pair(ENTER, n));
     }
 
+    void theory_datatype::oc_add_todo(theory_var v) {
+        m_oc_todo.push_back(v);
+        m_trail_stack.push(push_back_vector<theory_datatype, svector<theory_var>>(m_oc_todo));
+    }
+
 
     theory* theory_datatype::mk_fresh(context* new_ctx) { 
         return alloc(theory_datatype, new_ctx->get_manager(), m_params); 
@@ -266,6 +271,14 @@ namespace smt {
         ctx.attach_th_var(n, this, r);
         if (is_constructor(n)) {
             d->m_constructor = n;
+            oc_add_todo(r);
+            ast_manager & m = get_manager();
+            for (enode * arg : enode::args(n)) {
+                sort * s = m.get_sort(arg->get_owner());
+                if (m_autil.is_array(s) && m_util.is_datatype(get_array_range(s))) {
+                    m_oc_full = true;
+                }
+            }
             assert_accessor_axioms(n);
         }
         else if (is_update_field(n)) {
@@ -472,14 +485,29 @@ namespace smt {
         int num_vars = get_num_vars();
         final_check_status r = FC_DONE;
         final_check_st _guard(this); // RAII for managing state
-        for (int v = 0; v < num_vars; v++) {
-            if (v == static_cast<int>(m_find.find(v))) {
-                enode * node = get_enode(v);
+        if (m_oc_full) {
+            for (int v = 0; v < num_vars; v++) {
+                if (v == static_cast<int>(m_find.find(v)) && !oc_cycle_free(get_enode(v)) && occurs_check(get_enode(v))) {
+                    return FC_CONTINUE;
+                }
+            }
+        }
+        else {
+            // the constructor graph was acyclic when m_oc_todo_head was last set.
+            // Backtracking only removes edges, so it suffices to start from updated classes.
+            for (unsigned i = m_oc_todo_head; i < m_oc_todo.size(); ++i) {
+                enode * node = get_enode(m_find.find(m_oc_todo[i]));
                 if (!oc_cycle_free(node) && occurs_check(node)) {
-                    // conflict was detected... 
-                    // return...
                     return FC_CONTINUE;
                 }
+            }
+        }
+        if (m_oc_todo_head != m_oc_todo.size()) {
+            m_trail_stack.push(value_trail<theory_datatype, unsigned>(m_oc_todo_head));
+            m_oc_todo_head = m_oc_todo.size();
+        }
+        for (int v = 0; v < num_vars; v++) {
+            if (v == static_cast<int>(m_find.find(v))) {
                 if (m_params.m_dt_lazy_splits > 0) {
                     // using lazy case splits...
                     var_data * d = m_var_data[v];
@@ -672,6 +700,9 @@ namespace smt {
         m_trail_stack.reset();
         std::for_each(m_var_data.begin(), m_var_data.end(), delete_proc<var_data>());
         m_var_data.reset();
+        m_oc_todo.reset();
+        m_oc_todo_head = 0;
+        m_oc_full = false;
         theory::reset_eh();
         m_util.reset();
         m_stats.reset();
@@ -691,7 +722,9 @@ namespace smt {
         m_util(m),
         m_autil(m),
         m_find(*this),
-        m_trail_stack(*this) {
+        m_trail_stack(*this),
+        m_oc_todo_head(0),
+        m_oc_full(false) {
     }
 
     theory_datatype::~theory_datatype() {
@@ -776,6 +809,7 @@ namespace smt {
         SASSERT(v1 == static_cast<int>(m_find.find(v1)));
         var_data * d1 = m_var_data[v1];
         var_data * d2 = m_var_data[v2];
+        oc_add_todo(v1);
         if (d2->m_constructor != nullptr) {
             context & ctx = get_context();
             if (d1->m_constructor != nullptr && d1->m_constructor->get_decl() != d2->m_constructor->get_decl()) {
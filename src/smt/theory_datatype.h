@@ -84,6 +84,15 @@ namespace smt {
         parent_tbl            m_parent; // parent explanation for occurs_check
         svector<stack_entry>  m_stack; // stack for DFS for occurs_check
 
+        // Variables whose equivalence class obtained a constructor or was merged.
+        // A new cycle has to pass through one of them, so occurs_check only starts
+        // from variables at position m_oc_todo_head or later.
+        svector<theory_var>   m_oc_todo;
+        unsigned              m_oc_todo_head;
+        bool                  m_oc_full; // array arguments add edges without merges, check all classes.
+
+        void oc_add_todo(theory_var v);
+
         void oc_mark_on_stack(enode * n);
         bool oc_on_stack(enode * n) const { return n->get_root()->is_marked(); }
 
@@ -378,15 +378,18 @@ class theory_lra::imp {
         reset_variable_values();
         m_solver = alloc(lp::lar_solver); 
 
+        smt_params_helper lpar(ctx().get_params());
+        lp().settings().set_resource_limit(m_resource_limit);
+        // set before any column is added: the lu strategy keeps a double copy of the columns
+        lp().settings().simplex_strategy() = static_cast<lp::simplex_strategy_enum>(lpar.arith_simplex_strategy());
+        lp().settings().presolve_with_double_solver_for_lar = lpar.arith_presolve_with_doubles();
+
         // initialize 0, 1 variables:
         get_one(true);
         get_one(false);
         get_zero(true);
         get_zero(false);
 
-        smt_params_helper lpar(ctx().get_params());
-        lp().settings().set_resource_limit(m_resource_limit);
-        lp().settings().simplex_strategy() = static_cast<lp::simplex_strategy_enum>(lpar.arith_simplex_strategy());
         lp().settings().bound_propagation() = BP_NONE != propagation_mode();
         lp().settings().m_enable_hnf = lpar.arith_enable_hnf();
         lp().settings().m_print_external_var_name = lpar.arith_print_ext_var_names();
@@ -3852,6 +3855,7 @@ public:
         st.update("arith-horner-cross-nested-forms", lp().settings().stats().m_cross_nested_forms);
         st.update("arith-grobner-calls", lp().settings().stats().m_grobner_calls);
         st.update("arith-grobner-conflicts", lp().settings().stats().m_grobner_conflicts);
+        st.update("arith-grobner-reused", lp().settings().stats().m_grobner_reused);
         st.update("arith-nla-explanations", m_stats.m_nla_explanations);
         st.update("arith-nla-lemmas", m_stats.m_nla_lemmas);
         st.update("arith-gomory-cuts", m_stats.m_gomory_cuts);
@@ -322,12 +322,34 @@ theory_seq::theory_seq(ast_manager& m, theory_seq_params const & params):
     m_post           = "seq.post"; // (seq.post s l): suffix of string s of length k, based on extract starting at index i of length l
     m_eq             = "seq.eq";
     m_seq_align      = "seq.align";
+    if (params.m_seq_automata_cache_size > 0) {
+        set_automata_cache(alloc(eautomaton_cache, m, params.m_seq_automata_cache_size));
+    }
 }
 
 theory_seq::~theory_seq() {
     m_trail_stack.reset();
 }
 
+/**
+   \brief share the automata cache with the rewriter of the theory.
+   get_automaton memoizes automata in m_re2aut only for the current
+   search, init_search_eh resets it. The cache is used by the rewriter,
+   by the next searches and by the clones created by mk_fresh.
+*/
+void theory_seq::set_automata_cache(eautomaton_cache* c) {
+    m_mk_aut.set_cache(c);
+    m_seq_rewrite.set_automata_cache(c);
+}
+
+theory* theory_seq::mk_fresh(context* new_ctx) {
+    theory_seq* th = alloc(theory_seq, new_ctx->get_manager(), m_params);
+    if (&new_ctx->get_manager() == &m && m_mk_aut.get_cache()) {
+        th->set_automata_cache(m_mk_aut.get_cache());
+    }
+    return th;
+}
+
 void theory_seq::init(context* ctx) {
     theory::init(ctx);    
     m_arith_value.init(ctx);
@@ -4223,6 +4245,9 @@ void theory_seq::collect_statistics(::statistics & st) const {
     st.update("seq fixed length", m_stats.m_fixed_length);
     st.update("seq int.to.str", m_stats.m_int_string);
     st.update("seq automata", m_stats.m_propagate_automata);
+    if (m_mk_aut.get_cache()) {
+        m_mk_aut.get_cache()->collect_statistics(st);
+    }
 }
 
 void theory_seq::init_search_eh() {
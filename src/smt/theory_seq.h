@@ -438,7 +438,7 @@ namespace smt {
         void relevant_eh(app* n) override;
         bool should_research(expr_ref_vector &) override;
         void add_theory_assumptions(expr_ref_vector & assumptions) override;
-        theory* mk_fresh(context* new_ctx) override { return alloc(theory_seq, new_ctx->get_manager(), m_params); }
+        theory* mk_fresh(context* new_ctx) override;
         char const * get_name() const override { return "seq"; }
         bool include_func_interp(func_decl* f) override { return m_util.str.is_nth_u(f); }
         theory_var mk_var(enode* n) override;
@@ -687,6 +687,7 @@ namespace smt {
         // automata utilities
         void propagate_in_re(expr* n, bool is_true);
         eautomaton* get_automaton(expr* e);
+        void set_automata_cache(eautomaton_cache* c);
         literal mk_accept(expr* s, expr* idx, expr* re, expr* state);
         literal mk_accept(expr* s, expr* idx, expr* re, unsigned i) { return mk_accept(s, idx, re, m_autil.mk_int(i)); }
         bool is_accept(expr* acc) const {  return is_skolem(m_accept, acc); }
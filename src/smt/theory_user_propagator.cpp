@@ -0,0 +1,182 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    theory_user_propagator.cpp
+
+Abstract:
+
+    Theory plugin that forwards search events on registered terms
+    to a user propagator and asserts the consequences it propagates.
+
+Notes:
+
+--*/
+
+#include "util/trail.h"
+#include "smt/theory_user_propagator.h"
+#include "smt/smt_context.h"
+
+using namespace smt;
+
+theory_user_propagator::theory_user_propagator(ast_manager& m):
+    theory(m.mk_family_id("user_propagator")),
+    m(m),
+    m_user_context(nullptr),
+    m_qhead(0)
+{}
+
+theory * theory_user_propagator::mk_fresh(context * new_ctx) {
+    return alloc(theory_user_propagator, new_ctx->get_manager());
+}
+
+unsigned theory_user_propagator::add_expr(expr* e) {
+    context& ctx = get_context();
+    if (!is_app(e))
+        throw default_exception("only applications can be registered with a user propagator");
+    // the internalizer expects terms in the normal form produced by the rewriter.
+    // Other terms are registered through a fresh constant, and the equality
+    // between the two is preprocessed with the other assertions.
+    expr_ref r(m);
+    ctx.get_rewriter()(e, r);
+    if (r != e) {
+        r = m.mk_fresh_const("user", m.get_sort(e));
+        ctx.assert_expr(m.mk_eq(r, e));
+        e = r;
+    }
+    if (!ctx.e_internalized(e))
+        ctx.internalize(e, false);
+    enode* n = ctx.get_enode(e);
+    if (is_attached_to_var(n))
+        return n->get_th_var(get_id());
+    theory_var v = mk_var(n);
+    ctx.attach_th_var(n, this, v);
+    ctx.mark_as_relevant(n);
+    if (m.is_bool(e) && ctx.get_assignment(e) != l_undef)
+        m_pending_fixed.push_back(v);
+    return v;
+}
+
+void theory_user_propagator::new_fixed_eh(bool_var v, bool is_true) {
+    context& ctx = get_context();
+    theory_var tv = ctx.bool_var2enode(v)->get_th_var(get_id());
+    if (tv != null_theory_var)
+        notify_fixed(tv, is_true);
+}
+
+void theory_user_propagator::notify_fixed(theory_var v, bool is_true) {
+    if (m_fixed_eh)
+        m_fixed_eh(m_user_context, this, v, is_true ? m.mk_true() : m.mk_false());
+}
+
+void theory_user_propagator::new_eq_eh(theory_var v1, theory_var v2) {
+    if (m_eq_eh)
+        m_eq_eh(m_user_context, this, v1, v2);
+}
+
+void theory_user_propagator::propagate_cb(
+    unsigned num_fixed, unsigned const* fixed_ids,
+    unsigned num_eqs, unsigned const* eq_lhs, unsigned const* eq_rhs,
+    expr* conseq) {
+    context& ctx = get_context();
+    for (unsigned i = 0; i < num_fixed; ++i)
+        if (fixed_ids[i] >= get_num_vars() || !m.is_bool(get_enode(fixed_ids[i])->get_owner()))
+            throw default_exception("propagation is justified by an identifier that is not a registered Boolean term");
+    for (unsigned i = 0; i < num_eqs; ++i)
+        if (eq_lhs[i] >= get_num_vars() || eq_rhs[i] >= get_num_vars())
+            throw default_exception("propagation is justified by an identifier that is not a registered term");
+    ctx.push_trail(push_back_vector<context, vector<prop_info>>(m_prop));
+    m_prop.push_back(prop_info(num_fixed, fixed_ids, num_eqs, eq_lhs, eq_rhs, expr_ref(conseq, m)));
+}
+
+void theory_user_propagator::push_scope_eh() {
+    theory::push_scope_eh();
+    if (m_push_eh)
+        m_push_eh(m_user_context);
+}
+
+void theory_user_propagator::pop_scope_eh(unsigned num_scopes) {
+    if (m_pop_eh)
+        m_pop_eh(m_user_context, num_scopes);
+    theory::pop_scope_eh(num_scopes);
+}
+
+bool theory_user_propagator::can_propagate() {
+    return m_qhead < m_prop.size() || !m_pending_fixed.empty();
+}
+
+void theory_user_propagator::propagate() {
+    context& ctx = get_context();
+    if (!m_pending_fixed.empty()) {
+        svector<theory_var> pending(m_pending_fixed);
+        m_pending_fixed.reset();
+        for (theory_var v : pending) {
+            lbool val = ctx.get_assignment(get_enode(v)->get_owner());
+            if (val != l_undef)
+                notify_fixed(v, val == l_true);
+        }
+    }
+    if (m_qhead == m_prop.size())
+        return;
+    ctx.push_trail(value_trail<context, unsigned>(m_qhead));
+    while (m_qhead < m_prop.size() && !ctx.inconsistent()) {
+        propagate_consequence(m_prop[m_qhead]);
+        ++m_qhead;
+    }
+}
+
+void theory_user_propagator::propagate_consequence(prop_info const& prop) {
+    context& ctx = get_context();
+    literal_vector lits;
+    enode_pair_vector eqs;
+    for (unsigned id : prop.m_ids) {
+        expr* e = get_enode(id)->get_owner();
+        lbool val = ctx.get_assignment(e);
+        if (val == l_undef)
+            throw default_exception("propagation is justified by a term that is not fixed");
+        literal lit = ctx.get_literal(e);
+        lits.push_back(val == l_true ? lit : ~lit);
+    }
+    for (unsigned i = 0; i < prop.m_lhs.size(); ++i) {
+        enode* a = get_enode(prop.m_lhs[i]), *b = get_enode(prop.m_rhs[i]);
+        if (a->get_root() != b->get_root())
+            throw default_exception("propagation is justified by terms that are not equal");
+        eqs.push_back(enode_pair(a, b));
+    }
+
+    expr_ref conseq(m);
+    ctx.get_rewriter()(prop.m_conseq, conseq);
+    if (m.is_true(conseq))
+        return;
+    if (m.is_false(conseq)) {
+        m_stats.m_num_conflicts++;
+        ctx.set_conflict(
+            ctx.mk_justification(
+                ext_theory_conflict_justification(
+                    get_id(), ctx.get_region(), lits.size(), lits.c_ptr(), eqs.size(), eqs.c_ptr(), 0, nullptr)));
+        return;
+    }
+    if (!ctx.b_internalized(conseq))
+        ctx.internalize(conseq, false);
+    literal lit = ctx.get_literal(conseq);
+    ctx.mark_as_relevant(lit);
+    if (ctx.get_assignment(lit) == l_true)
+        return;
+    m_stats.m_num_propagations++;
+    ctx.assign(lit,
+               ctx.mk_justification(
+                   ext_theory_propagation_justification(
+                       get_id(), ctx.get_region(), lits.size(), lits.c_ptr(), eqs.size(), eqs.c_ptr(), lit, 0, nullptr)));
+}
+
+final_check_status theory_user_propagator::final_check_eh() {
+    if (m_final_eh)
+        m_final_eh(m_user_context, this);
+    return can_propagate() ? FC_CONTINUE : FC_DONE;
+}
+
+void theory_user_propagator::collect_statistics(::statistics & st) const {
+    st.update("user propagations", m_stats.m_num_propagations);
+    st.update("user conflicts", m_stats.m_num_conflicts);
+}
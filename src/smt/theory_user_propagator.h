@@ -0,0 +1,126 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    theory_user_propagator.h
+
+Abstract:
+
+    Theory plugin that forwards search events on registered terms
+    to a user propagator and asserts the consequences it propagates.
+
+Notes:
+
+    Terms are registered before search starts. The identifier
+    returned for a registered term is its theory variable.
+
+    The propagator is initialized at base level, so every call to
+    push_eh is matched by a later call to pop_eh.
+
+    Fixed notifications are produced for Boolean terms.
+    Equality notifications are produced for terms of any sort.
+
+--*/
+#ifndef THEORY_USER_PROPAGATOR_H_
+#define THEORY_USER_PROPAGATOR_H_
+
+#include "smt/smt_theory.h"
+#include "solver/user_propagator_base.h"
+
+namespace smt {
+
+    class theory_user_propagator : public theory, public user_propagator::callback {
+
+        struct prop_info {
+            unsigned_vector  m_ids;
+            unsigned_vector  m_lhs;
+            unsigned_vector  m_rhs;
+            expr_ref         m_conseq;
+            prop_info(unsigned num_fixed, unsigned const* fixed_ids,
+                      unsigned num_eqs, unsigned const* lhs, unsigned const* rhs, expr_ref const& c):
+                m_ids(num_fixed, fixed_ids),
+                m_lhs(num_eqs, lhs),
+                m_rhs(num_eqs, rhs),
+                m_conseq(c) {}
+        };
+
+        struct stats {
+            unsigned m_num_propagations;
+            unsigned m_num_conflicts;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        ast_manager&                   m;
+        void*                          m_user_context;
+        user_propagator::push_eh_t     m_push_eh;
+        user_propagator::pop_eh_t      m_pop_eh;
+        user_propagator::fixed_eh_t    m_fixed_eh;
+        user_propagator::final_eh_t    m_final_eh;
+        user_propagator::eq_eh_t       m_eq_eh;
+        vector<prop_info>              m_prop;
+        unsigned                       m_qhead;
+        svector<theory_var>            m_pending_fixed;
+        stats                          m_stats;
+
+        void notify_fixed(theory_var v, bool is_true);
+        void propagate_consequence(prop_info const& prop);
+
+    public:
+        theory_user_propagator(ast_manager& m);
+
+        ~theory_user_propagator() override {}
+
+        /*
+         * \brief initial setup for user propagator.
+         */
+        void add(void* ctx,
+                 user_propagator::push_eh_t& push_eh,
+                 user_propagator::pop_eh_t& pop_eh) {
+            m_user_context = ctx;
+            m_push_eh      = push_eh;
+            m_pop_eh       = pop_eh;
+        }
+
+        unsigned add_expr(expr* e);
+
+        void register_fixed(user_propagator::fixed_eh_t& fixed_eh) { m_fixed_eh = fixed_eh; }
+        void register_final(user_propagator::final_eh_t& final_eh) { m_final_eh = final_eh; }
+        void register_eq(user_propagator::eq_eh_t& eq_eh) { m_eq_eh = eq_eh; }
+
+        void propagate_cb(unsigned num_fixed, unsigned const* fixed_ids,
+                          unsigned num_eqs, unsigned const* eq_lhs, unsigned const* eq_rhs,
+                          expr* conseq) override;
+
+        /**
+           \brief the Boolean variable v was assigned.
+           Called by the context for Boolean variables attached to enodes.
+        */
+        void new_fixed_eh(bool_var v, bool is_true);
+
+        char const * get_name() const override { return "user_propagate"; }
+        bool internalize_atom(app* atom, bool gate_ctx) override { UNREACHABLE(); return false; }
+        bool internalize_term(app* term) override { UNREACHABLE(); return false; }
+        void new_eq_eh(theory_var v1, theory_var v2) override;
+        void new_diseq_eh(theory_var v1, theory_var v2) override {}
+        bool use_diseqs() const override { return false; }
+        bool build_models() const override { return false; }
+        final_check_status final_check_eh() override;
+        void reset_eh() override {}
+        void push_scope_eh() override;
+        void pop_scope_eh(unsigned num_scopes) override;
+        bool can_propagate() override;
+        void propagate() override;
+        void collect_statistics(::statistics & st) const override;
+        void display(std::ostream& out) const override {}
+        /**
+           \brief auxiliary contexts, such as the ones used by model based
+           quantifier instantiation, get a propagator without callbacks or
+           registered terms.
+        */
+        theory * mk_fresh(context * new_ctx) override;
+    };
+};
+
+#endif
@@ -312,6 +312,33 @@ public:
             return m_solver2->get_trail();
     }
 
+    void user_propagate_init(
+        void* ctx, 
+        user_propagator::push_eh_t& push_eh,
+        user_propagator::pop_eh_t& pop_eh) override {
+        // the propagator is attached to the incremental solver,
+        // so the non-incremental solver must not be used from now on.
+        m_ignore_solver1 = true;
+        switch_inc_mode();
+        m_solver2->user_propagate_init(ctx, push_eh, pop_eh);
+    }
+
+    void user_propagate_register_fixed(user_propagator::fixed_eh_t& fixed_eh) override {
+        m_solver2->user_propagate_register_fixed(fixed_eh);
+    }
+
+    void user_propagate_register_final(user_propagator::final_eh_t& final_eh) override {
+        m_solver2->user_propagate_register_final(final_eh);
+    }
+
+    void user_propagate_register_eq(user_propagator::eq_eh_t& eq_eh) override {
+        m_solver2->user_propagate_register_eq(eq_eh);
+    }
+
+    unsigned user_propagate_register(expr* e) override {
+        return m_solver2->user_propagate_register(e);
+    }
+
     proof * get_proof() override {
         if (m_use_solver1_results)
             return m_solver1->get_proof();
@@ -21,6 +21,7 @@ Notes:
 
 #include "solver/check_sat_result.h"
 #include "solver/progress_callback.h"
+#include "solver/user_propagator_base.h"
 #include "util/params.h"
 
 class solver;
@@ -253,6 +254,35 @@ public:
     
     virtual void get_levels(ptr_vector<expr> const& vars, unsigned_vector& depth) = 0;
 
+    /**
+       \brief attach a user propagator.
+       The propagator is notified on push and pop, and on the events
+       registered with the user_propagate_register_* methods,
+       for terms registered using user_propagate_register.
+    */
+    virtual void user_propagate_init(
+        void* ctx, 
+        user_propagator::push_eh_t&   push_eh,
+        user_propagator::pop_eh_t&    pop_eh) {
+        throw default_exception("user-propagators are only supported by the SMT solver");
+    }
+
+    virtual void user_propagate_register_fixed(user_propagator::fixed_eh_t& fixed_eh) {
+        throw default_exception("user-propagators are only supported by the SMT solver");
+    }
+
+    virtual void user_propagate_register_final(user_propagator::final_eh_t& final_eh) {
+        throw default_exception("user-propagators are only supported by the SMT solver");
+    }
+
+    virtual void user_propagate_register_eq(user_propagator::eq_eh_t& eq_eh) {
+        throw default_exception("user-propagators are only supported by the SMT solver");
+    }
+
+    virtual unsigned user_propagate_register(expr* e) { 
+        throw default_exception("user-propagators are only supported by the SMT solver");
+    }
+
     class scoped_push {
         solver& s;
         bool    m_nopop;
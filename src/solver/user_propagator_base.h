@@ -0,0 +1,53 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    user_propagator_base.h
+
+Abstract:
+
+    Callback interface for user propagators.
+
+    A user propagator watches registered terms during search.
+    It is notified when a registered Boolean term is assigned,
+    when two registered terms become equal, and at final check.
+    From within these notifications it can propagate consequences
+    justified by fixed terms and equalities between registered terms.
+
+Notes:
+
+    Registered terms are identified by the unsigned returned
+    when they are registered.
+
+--*/
+#ifndef USER_PROPAGATOR_BASE_H_
+#define USER_PROPAGATOR_BASE_H_
+
+#include "ast/ast.h"
+#include <functional>
+
+namespace user_propagator {
+
+    class callback {
+    public:
+        virtual ~callback() {}
+        /**
+           \brief propagate conseq, justified by the current values of the
+           terms fixed_ids and the equalities eq_lhs[i] = eq_rhs[i].
+           If conseq is false, the justification is a conflict.
+        */
+        virtual void propagate_cb(unsigned num_fixed, unsigned const* fixed_ids,
+                                  unsigned num_eqs, unsigned const* eq_lhs, unsigned const* eq_rhs,
+                                  expr* conseq) = 0;
+    };
+
+    typedef std::function<void(void*, callback*, unsigned, expr*)>    fixed_eh_t;
+    typedef std::function<void(void*, callback*)>                     final_eh_t;
+    typedef std::function<void(void*, callback*, unsigned, unsigned)> eq_eh_t;
+    typedef std::function<void(void*)>                                push_eh_t;
+    typedef std::function<void(void*, unsigned)>                      pop_eh_t;
+
+}
+
+#endif
@@ -163,6 +163,9 @@ struct ctx_simplify_tactic::imp {
     unsigned                    m_max_depth;
     unsigned                    m_max_steps;
     bool                        m_bail_on_blowup;
+    bool                        m_reuse_outer;
+    unsigned                    m_max_shared_visits;
+    obj_map<expr, unsigned>     m_shared_visits;
 
     imp(ast_manager & _m, simplifier* simp, params_ref const & p):
         m(_m),
@@ -197,6 +200,8 @@ struct ctx_simplify_tactic::imp {
         m_max_steps    = p.get_uint("max_steps", UINT_MAX);
         m_max_depth    = p.get_uint("max_depth", 1024);
         m_bail_on_blowup = p.get_bool("bail_on_blowup", false);
+        m_reuse_outer  = p.get_bool("reuse_outer", false);
+        m_max_shared_visits = p.get_uint("max_shared_visits", UINT_MAX);
         m_simp->updt_params(p);
     }
 
@@ -314,7 +319,10 @@ struct ctx_simplify_tactic::imp {
             return false;
         cache_cell & cell = m_cache[id];
         SASSERT(cell.m_result == 0 || cell.m_result->m_lvl <= scope_level());
-        if (cell.m_result != nullptr && cell.m_result->m_lvl == scope_level()) {
+        // A result cached at a lower level was computed under a prefix of the
+        // current assumptions, i.e., in a context that dominates the current one.
+        // It remains valid, though it may be less simplified.
+        if (cell.m_result != nullptr && (m_reuse_outer || cell.m_result->m_lvl == scope_level())) {
             SASSERT(cell.m_from == t);
             SASSERT(cell.m_result->m_to != 0);
             r = cell.m_result->m_to;
@@ -335,6 +343,16 @@ struct ctx_simplify_tactic::imp {
             SASSERT(r.get() != 0);
             return;
         }
+        if (m_max_shared_visits != UINT_MAX && shared(t)) {
+            // bound the number of contexts a shared subterm is simplified in.
+            // Leaving t unchanged is sound in every context.
+            unsigned & n = m_shared_visits.insert_if_not_there2(t, 0)->get_data().m_value;
+            if (n >= m_max_shared_visits) {
+                r = t;
+                return;
+            }
+            ++n;
+        }
         m_num_steps++;
         m_depth++;
         if (m.is_or(t))
@@ -539,6 +557,7 @@ struct ctx_simplify_tactic::imp {
         pop(scope_level() - old_lvl);
 
         m_occs(g);
+        m_shared_visits.reset();
 
         // go backwards
         sz = g.size();
@@ -572,6 +591,7 @@ struct ctx_simplify_tactic::imp {
 
     void operator()(goal & g) {
         m_occs.reset();
+        m_shared_visits.reset();
         expr_ref_vector pinned(m);
         m_occs(g);
         unsigned sz = g.size();
@@ -621,6 +641,8 @@ void ctx_simplify_tactic::get_param_descrs(param_descrs & r) {
     insert_max_steps(r);
     r.insert("max_depth", CPK_UINT, "(default: 1024) maximum term depth.");
     r.insert("propagate_eq", CPK_BOOL, "(default: false) enable equality propagation from bounds.");
+    r.insert("reuse_outer", CPK_BOOL, "(default: false) reuse results of shared subterms that were simplified in an enclosing context.");
+    r.insert("max_shared_visits", CPK_UINT, "(default: infty) maximum number of contexts in which a shared subterm is simplified; further occurrences are left unchanged.");
 }
 
 void ctx_simplify_tactic::operator()(goal_ref const & in,
@@ -19,16 +19,38 @@ Notes:
 #include "tactic/core/simplify_tactic.h"
 #include "ast/rewriter/th_rewriter.h"
 #include "ast/ast_pp.h"
+#include "ast/ast_translation.h"
+#include "ast/rewriter/rewriter_params.hpp"
+#include "ast/rewriter/arith_rewriter_params.hpp"
+#include "ast/rewriter/poly_rewriter_params.hpp"
+#include "ast/for_each_expr.h"
+#include "ast/array_decl_plugin.h"
+#include "ast/seq_decl_plugin.h"
+#include "ast/pb_decl_plugin.h"
+#include "util/scoped_ptr_vector.h"
+#include <thread>
+#include <mutex>
+#include <exception>
 
 struct simplify_tactic::imp {
     ast_manager &   m_manager;
     th_rewriter     m_r;
     unsigned        m_num_steps;
+    params_ref      m_params;
+    unsigned        m_threads;
+    unsigned        m_threads_min_size;
 
     imp(ast_manager & m, params_ref const & p):
         m_manager(m),
         m_r(m, p),
         m_num_steps(0) {
+        updt_params(p);
+    }
+
+    void updt_params(params_ref const & p) {
+        m_params           = p;
+        m_threads          = p.get_uint("threads", 1);
+        m_threads_min_size = p.get_uint("threads.min_size", 10000);
     }
 
     ~imp() {
@@ -42,6 +64,115 @@ struct simplify_tactic::imp {
         m_num_steps = 0;
     }
 
+    struct found {};
+
+    struct id_sensitive_proc {
+        array_util  m_array;
+        seq_util    m_seq;
+        family_id   m_pb_fid;
+        id_sensitive_proc(ast_manager & m): m_array(m), m_seq(m), m_pb_fid(pb_util(m).get_family_id()) {}
+        void operator()(var * n) {}
+        void operator()(quantifier * n) {}
+        void operator()(app * n) {
+            if (n->get_family_id() == m_pb_fid || m_array.is_map(n) || m_seq.is_re(n))
+                throw found();
+        }
+    };
+
+    /**
+       \brief Return true if rewriting g may order arguments by expression id.
+
+       The ids of the private managers used by par_rewrite differ from the ids of m(),
+       so the rewrites that sort by id (hoist_cmul and sort_sums, pseudo-Boolean
+       constraints, array maps, regular expression derivatives) would make the
+       result depend on the number of threads. Such goals are rewritten sequentially.
+    */
+    bool is_id_sensitive(goal const & g) {
+        if (poly_rewriter_params(m_params).hoist_cmul() || arith_rewriter_params(m_params).sort_sums())
+            return true;
+        id_sensitive_proc proc(m());
+        expr_fast_mark1 visited;
+        try {
+            for (unsigned i = 0; i < g.size(); ++i)
+                quick_for_each_expr(proc, visited, g.form(i));
+        }
+        catch (const found &) {
+            return true;
+        }
+        return false;
+    }
+
+    /**
+       \brief Rewrite the formulas of g on m_threads workers.
+       
+       The formulas are split into contiguous blocks. Each block is translated
+       into a private manager and rewritten there with its own th_rewriter and cache.
+       The results are translated back in the original order. Together with
+       is_id_sensitive this makes the resulting goal independent of the number of
+       threads.
+    */
+    void par_rewrite(goal & g, expr_ref_vector & results) {
+        unsigned size      = g.size();
+        unsigned num_tasks = std::min(m_threads, size);
+        scoped_ptr_vector<ast_manager> managers;
+        scoped_limits scl(m().limit());
+        vector<expr_ref_vector> inputs;
+        vector<expr_ref_vector> outputs;
+        unsigned_vector num_steps;
+        for (unsigned i = 0; i < num_tasks; ++i) {
+            ast_manager * new_m = alloc(ast_manager, m(), !m().proof_mode());
+            managers.push_back(new_m);
+            scl.push_child(&new_m->limit());
+            ast_translation translator(m(), *new_m);
+            inputs.push_back(expr_ref_vector(*new_m));
+            outputs.push_back(expr_ref_vector(*new_m));
+            num_steps.push_back(0);
+            unsigned lo = (size * i) / num_tasks, hi = (size * (i + 1)) / num_tasks;
+            for (unsigned idx = lo; idx < hi; ++idx) 
+                inputs[i].push_back(translator(g.form(idx)));
+        }
+
+        std::mutex         mux;
+        std::exception_ptr ex;
+        auto worker_thread = [&](unsigned i) {
+            try {
+                th_rewriter rw(*managers[i], m_params);
+                expr_ref r(*managers[i]);
+                for (expr * e : inputs[i]) {
+                    rw(e, r);
+                    outputs[i].push_back(r);
+                }
+                num_steps[i] = rw.get_num_steps();
+            }
+            catch (...) {
+                // the first failure is re-raised on the calling thread;
+                // the other workers are canceled.
+                std::lock_guard<std::mutex> lock(mux);
+                if (!ex) {
+                    ex = std::current_exception();
+                    for (ast_manager * other : managers) 
+                        other->limit().cancel();
+                }
+            }
+        };
+        vector<std::thread> threads(num_tasks);
+        for (unsigned i = 0; i < num_tasks; ++i) {
+            threads[i] = std::thread([&, i]() { worker_thread(i); });
+        }
+        for (unsigned i = 0; i < num_tasks; ++i) {
+            threads[i].join();
+        }
+        if (ex) 
+            std::rethrow_exception(ex);
+
+        for (unsigned i = 0; i < num_tasks; ++i) {
+            ast_translation translator(*managers[i], m(), false);
+            for (expr * e : outputs[i]) 
+                results.push_back(translator(e));
+            m_num_steps += num_steps[i];
+        }
+    }
+
     void operator()(goal & g) {
         tactic_report report("simplifier", g);
         m_num_steps = 0;
@@ -50,6 +181,18 @@ struct simplify_tactic::imp {
         expr_ref   new_curr(m());
         proof_ref  new_pr(m());
         unsigned size = g.size();
+        if (m_threads > 1 && size >= m_threads_min_size && !g.proofs_enabled() && !is_id_sensitive(g)) {
+            expr_ref_vector results(m());
+            par_rewrite(g, results);
+            for (unsigned idx = 0; idx < size; idx++) {
+                if (g.inconsistent())
+                    break;
+                g.update(idx, results.get(idx), nullptr, g.dep(idx));
+            }
+            TRACE("simplifier", g.display(tout););
+            g.elim_redundancies();
+            return;
+        }
         for (unsigned idx = 0; idx < size; idx++) {
             if (g.inconsistent())
                 break;
@@ -73,6 +216,16 @@ struct simplify_tactic::imp {
 simplify_tactic::simplify_tactic(ast_manager & m, params_ref const & p):
     m_params(p) {
     m_imp = alloc(imp, m, p);
+    updt_memo();
+}
+
+void simplify_tactic::updt_memo() {
+    unsigned memo_size = rewriter_params(m_params).memo_size();
+    if (memo_size == 0)
+        m_memo = nullptr;
+    else if (!m_memo)
+        m_memo = alloc(th_rewriter_memo, m_imp->m(), memo_size);
+    m_imp->m_r.set_memo(m_memo.get());
 }
 
 simplify_tactic::~simplify_tactic() {
@@ -82,10 +235,14 @@ simplify_tactic::~simplify_tactic() {
 void simplify_tactic::updt_params(params_ref const & p) {
     m_params = p;
     m_imp->m_r.updt_params(p);
+    m_imp->updt_params(p);
+    updt_memo();
 }
 
 void simplify_tactic::get_param_descrs(param_descrs & r) {
     th_rewriter::get_param_descrs(r);
+    r.insert("threads", CPK_UINT, "(default: 1) number of threads used to rewrite the formulas of large goals. Goals whose rewriting orders arguments by expression id (hoist_cmul, sort_sums, pseudo-Boolean constraints, array maps, regular expressions) are rewritten on one thread.");
+    r.insert("threads.min_size", CPK_UINT, "(default: 10000) minimal number of formulas in a goal for using more than one thread.");
 }
 
 void simplify_tactic::operator()(goal_ref const & in, 
@@ -106,6 +263,12 @@ void simplify_tactic::cleanup() {
     params_ref p = std::move(m_params);
     m_imp->~imp();
     new (m_imp) imp(m, p);
+    m_imp->m_r.set_memo(m_memo.get());
+}
+
+void simplify_tactic::collect_statistics(statistics & st) const {
+    if (m_memo)
+        m_memo->collect_statistics(st);
 }
 
 unsigned simplify_tactic::get_num_steps() const {
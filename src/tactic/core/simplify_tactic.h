@@ -21,11 +21,15 @@ Notes:
 
 #include "tactic/tactic.h"
 #include "tactic/tactical.h"
+#include "ast/rewriter/th_rewriter.h"
 
 class simplify_tactic : public tactic {
     struct     imp;
     imp *      m_imp;
     params_ref m_params;
+    // survives cleanup() so that repeated invocations reuse earlier results.
+    ref<th_rewriter_memo> m_memo;
+    void updt_memo();
 public:
     simplify_tactic(ast_manager & m, params_ref const & ref = params_ref());
     ~simplify_tactic() override;
@@ -40,6 +44,8 @@ public:
     
     void cleanup() override;
 
+    void collect_statistics(statistics & st) const override;
+
     unsigned get_num_steps() const;
 
     tactic * translate(ast_manager & m) override { return alloc(simplify_tactic, m, m_params); }
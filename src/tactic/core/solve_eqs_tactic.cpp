@@ -100,11 +100,49 @@ class solve_eqs_tactic : public tactic {
             return num <= m_max_occs;
         }
         
+        /**
+           \brief Occurs check that gives up after visiting a bounded number of subterms.
+           A full occurs check on every equation is quadratic on long chains of
+           definitions where each right-hand side contains the previous one.
+           If the check gives up, the equation is kept as a candidate. A variable
+           that does occur in its definition is then dropped by the cycle
+           detection in sort_vars.
+        */
+        bool occurs_bounded(expr * x, expr * t) {
+            if (is_quantifier(t))
+                return occurs(x, t);
+            expr_fast_mark1 visited;
+            ptr_buffer<expr, 128> todo;
+            unsigned budget = 1024;
+            todo.push_back(t);
+            while (!todo.empty()) {
+                expr * e = todo.back();
+                todo.pop_back();
+                if (e == x)
+                    return true;
+                if (visited.is_marked(e))
+                    continue;
+                if (budget == 0) 
+                    return false;
+                --budget;
+                visited.mark(e);
+                if (is_app(e)) {
+                    for (expr * arg : *to_app(e)) 
+                        todo.push_back(arg);
+                }
+                else if (is_quantifier(e)) {
+                    visited.reset();
+                    return occurs(x, t);
+                }
+            }
+            return false;
+        }
+
         // Use: (= x def) and (= def x)
 
         bool trivial_solve1(expr * lhs, expr * rhs, app_ref & var, expr_ref & def, proof_ref & pr) { 
 
-            if (is_uninterp_const(lhs) && !m_candidate_vars.is_marked(lhs) && !occurs(lhs, rhs) && check_occs(lhs)) {
+            if (is_uninterp_const(lhs) && !m_candidate_vars.is_marked(lhs) && !occurs_bounded(lhs, rhs) && check_occs(lhs)) {
                 var = to_app(lhs); 
                 def = rhs;
                 pr  = nullptr;
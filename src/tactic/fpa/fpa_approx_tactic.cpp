@@ -0,0 +1,335 @@
+/*++
+Copyright (c) 2019 Microsoft Corporation
+
+Module Name:
+
+    fpa_approx_tactic.cpp
+
+Abstract:
+
+    Precision-approximation tactic for QF_FP.
+
+Notes:
+
+    Every floating-point sort (eb, sb) is replaced by (min(eb, e), min(sb, s))
+    for the current approximation widths (e, s). Constants are replaced by
+    fresh constants of the reduced sort and numerals are rounded to nearest.
+    The reduced goal is solved with qffp. A model is widened back to the
+    original formats, which is exact, and the original goal is evaluated in it.
+
+    The approximation is sound for satisfiable answers only: whenever the
+    reduced goal is unsatisfiable or its model does not satisfy the original
+    goal, the widths are increased, and at full precision the original goal
+    is solved directly.
+
+--*/
+#include "tactic/tactical.h"
+#include "ast/ast_pp.h"
+#include "ast/for_each_expr.h"
+#include "ast/fpa_decl_plugin.h"
+#include "ast/bv_decl_plugin.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/rewriter/rewriter_def.h"
+#include "model/model_evaluator.h"
+#include "tactic/fpa/qffp_tactic.h"
+#include "tactic/fpa/fpa_approx_tactic.h"
+
+namespace {
+
+    struct unsupported {};
+
+    /**
+       \brief collect the maximal floating point format and the uninterpreted constants
+       of a goal; throw unsupported if the goal is not in QF_FP(BV).
+    */
+    struct fpa_approx_collect {
+        ast_manager &     m;
+        fpa_util          fu;
+        bv_util           bu;
+        arith_util        au;
+        unsigned          m_max_ebits;
+        unsigned          m_max_sbits;
+        ptr_vector<app>   m_consts;
+
+        fpa_approx_collect(ast_manager & m): m(m), fu(m), bu(m), au(m), m_max_ebits(0), m_max_sbits(0) {}
+
+        void operator()(var *) { throw unsupported(); }
+        void operator()(quantifier *) { throw unsupported(); }
+        void operator()(app * n) {
+            sort * s = m.get_sort(n);
+            if (fu.is_float(s)) {
+                m_max_ebits = std::max(m_max_ebits, fu.get_ebits(s));
+                m_max_sbits = std::max(m_max_sbits, fu.get_sbits(s));
+            }
+            else if (!m.is_bool(s) && !fu.is_rm(s) && !bu.is_bv_sort(s) && !au.is_real(s))
+                throw unsupported();
+            family_id fid = n->get_family_id();
+            if (is_uninterp_const(n))
+                m_consts.push_back(n);
+            else if (fid == fu.get_family_id() || fid == bu.get_family_id() || fid == m.get_basic_family_id())
+                return;
+            else if (au.is_real(s) && au.is_numeral(n))
+                return;
+            else
+                throw unsupported();
+        }
+    };
+
+    struct fpa_approx_rewriter_cfg : public default_rewriter_cfg {
+        ast_manager &           m;
+        fpa_util                fu;
+        unsigned                m_ebits;
+        unsigned                m_sbits;
+        obj_map<func_decl, app*> m_const2approx;
+        app_ref_vector          m_approx_consts;
+
+        fpa_approx_rewriter_cfg(ast_manager & m, unsigned ebits, unsigned sbits):
+            m(m), fu(m), m_ebits(ebits), m_sbits(sbits), m_approx_consts(m) {}
+
+        sort * approx(sort * s) {
+            if (!fu.is_float(s))
+                return s;
+            unsigned eb = fu.get_ebits(s), sb = fu.get_sbits(s);
+            if (eb <= m_ebits && sb <= m_sbits)
+                return s;
+            return fu.mk_float_sort(std::min(eb, m_ebits), std::min(sb, m_sbits));
+        }
+
+        bool args_changed(func_decl * f, unsigned num, expr * const * args) {
+            unsigned arity = f->get_arity();
+            for (unsigned i = 0; i < num; ++i)
+                if (m.get_sort(args[i]) != f->get_domain(std::min(i, arity - 1)))
+                    return true;
+            return false;
+        }
+
+        br_status reduce_app(func_decl * f, unsigned num, expr * const * args, expr_ref & result, proof_ref & result_pr) {
+            result_pr = nullptr;
+            family_id fid = f->get_family_id();
+            sort * s = f->get_range();
+            if (num == 0 && fid == null_family_id) {
+                if (approx(s) == s)
+                    return BR_FAILED;
+                app * c = nullptr;
+                if (!m_const2approx.find(f, c)) {
+                    c = m.mk_fresh_const(f->get_name().str().c_str(), approx(s));
+                    m_approx_consts.push_back(c);
+                    m_const2approx.insert(f, c);
+                }
+                result = c;
+                return BR_DONE;
+            }
+            if (fid == fu.get_family_id()) {
+                switch (f->get_decl_kind()) {
+                case OP_FPA_NUM:
+                case OP_FPA_PLUS_INF:
+                case OP_FPA_MINUS_INF:
+                case OP_FPA_NAN:
+                case OP_FPA_PLUS_ZERO:
+                case OP_FPA_MINUS_ZERO: {
+                    sort * as = approx(s);
+                    if (as == s)
+                        return BR_FAILED;
+                    scoped_mpf v(fu.fm()), av(fu.fm());
+                    app_ref n(m.mk_const(f), m);
+                    VERIFY(fu.is_numeral(n, v));
+                    fu.fm().set(av, fu.get_ebits(as), fu.get_sbits(as), MPF_ROUND_NEAREST_TEVEN, v);
+                    result = fu.mk_value(av);
+                    return BR_DONE;
+                }
+                case OP_FPA_TO_FP:
+                case OP_FPA_TO_FP_UNSIGNED: {
+                    // (to_fp bv) reinterprets the bits and depends on the exact format.
+                    if (num == 1 && !fu.is_float(args[0]))
+                        throw unsupported();
+                    sort * as = approx(s);
+                    if (as == s && !args_changed(f, num, args))
+                        return BR_FAILED;
+                    parameter ps[2] = { parameter(fu.get_ebits(as)), parameter(fu.get_sbits(as)) };
+                    result = m.mk_app(fid, f->get_decl_kind(), 2, ps, num, args);
+                    return BR_DONE;
+                }
+                case OP_FPA_FP:
+                case OP_FPA_TO_IEEE_BV:
+                case OP_FPA_BVWRAP:
+                case OP_FPA_BV2RM:
+                    if (approx(s) != s || args_changed(f, num, args))
+                        throw unsupported();
+                    return BR_FAILED;
+                default:
+                    break;
+                }
+            }
+            if (!args_changed(f, num, args))
+                return BR_FAILED;
+            if (fid != fu.get_family_id() && fid != m.get_basic_family_id())
+                throw unsupported();
+            result = m.mk_app(fid, f->get_decl_kind(), f->get_num_parameters(), f->get_parameters(), num, args);
+            return BR_DONE;
+        }
+    };
+
+    struct fpa_approx_rewriter : public rewriter_tpl<fpa_approx_rewriter_cfg> {
+        fpa_approx_rewriter_cfg m_cfg;
+        fpa_approx_rewriter(ast_manager & m, unsigned ebits, unsigned sbits):
+            rewriter_tpl<fpa_approx_rewriter_cfg>(m, false, m_cfg),
+            m_cfg(m, ebits, sbits) {}
+    };
+
+}
+
+class fpa_approx_tactic : public tactic {
+    struct stats {
+        unsigned m_num_rounds;
+        unsigned m_num_approx_sat;
+        stats() { reset(); }
+        void reset() { memset(this, 0, sizeof(*this)); }
+    };
+
+    ast_manager &   m;
+    params_ref      m_params;
+    tactic_ref      m_qffp;
+    unsigned        m_ebits;
+    unsigned        m_sbits;
+    stats           m_stats;
+
+    /**
+       \brief solve g with floating point widths reduced to at most (ebits, sbits).
+       If the reduced goal has a model that satisfies g at full precision, return it in mdl.
+    */
+    bool solve_approx(goal const & g, fpa_approx_collect const & info, unsigned ebits, unsigned sbits, model_ref & mdl) {
+        fpa_util fu(m);
+        fpa_approx_rewriter rw(m, ebits, sbits);
+        goal_ref ag = alloc(goal, m, false, true, false);
+        expr_ref new_f(m);
+        for (unsigned i = 0; i < g.size(); ++i) {
+            rw(g.form(i), new_f);
+            ag->assert_expr(new_f);
+        }
+        model_ref amdl;
+        labels_vec labels;
+        proof_ref pr(m);
+        expr_dependency_ref core(m);
+        std::string reason_unknown;
+        if (l_true != check_sat(*m_qffp, ag, amdl, labels, pr, core, reason_unknown) || !amdl)
+            return false;
+
+        model_evaluator aev(*amdl);
+        aev.set_model_completion(true);
+        mdl = alloc(model, m);
+        scoped_mpf v(fu.fm()), fv(fu.fm());
+        for (app * c : info.m_consts) {
+            func_decl * f = c->get_decl();
+            app * ac = nullptr;
+            if (!rw.m_cfg.m_const2approx.find(f, ac)) {
+                expr * val = amdl->get_const_interp(f);
+                if (val)
+                    mdl->register_decl(f, val);
+                continue;
+            }
+            expr_ref val = aev(ac);
+            if (!fu.is_numeral(val, v))
+                return false;
+            sort * s = f->get_range();
+            fu.fm().set(fv, fu.get_ebits(s), fu.get_sbits(s), MPF_ROUND_NEAREST_TEVEN, v);
+            mdl->register_decl(f, fu.mk_value(fv));
+        }
+
+        model_evaluator ev(*mdl);
+        ev.set_model_completion(true);
+        for (unsigned i = 0; i < g.size(); ++i) {
+            if (!ev.is_true(g.form(i))) {
+                TRACE("fpa_approx", tout << "violated at full precision: " << mk_pp(g.form(i), m) << "\n";);
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    fpa_approx_tactic(ast_manager & m, params_ref const & p):
+        m(m),
+        m_params(p),
+        m_qffp(mk_qffp_tactic(m, p)) {
+        updt_params(p);
+    }
+
+    tactic * translate(ast_manager & m) override {
+        return alloc(fpa_approx_tactic, m, m_params);
+    }
+
+    void updt_params(params_ref const & p) override {
+        m_params = p;
+        m_ebits = std::max(2u, p.get_uint("approx_ebits", 5));
+        m_sbits = std::max(3u, p.get_uint("approx_sbits", 11));
+        m_qffp->updt_params(p);
+    }
+
+    void collect_param_descrs(param_descrs & r) override {
+        r.insert("approx_ebits", CPK_UINT, "(default: 5) exponent width of the first approximation used by qffp-approx.");
+        r.insert("approx_sbits", CPK_UINT, "(default: 11) significand width of the first approximation used by qffp-approx.");
+        m_qffp->collect_param_descrs(r);
+    }
+
+    void operator()(goal_ref const & g, goal_ref_buffer & result) override {
+        tactic_report report("qffp-approx", *g);
+        fpa_approx_collect info(m);
+        bool approximate = !g->proofs_enabled() && !g->unsat_core_enabled() && !g->inconsistent();
+        if (approximate) {
+            try {
+                expr_mark visited;
+                for (unsigned i = 0; i < g->size(); ++i)
+                    for_each_expr(info, visited, g->form(i));
+            }
+            catch (unsupported) {
+                approximate = false;
+            }
+        }
+        unsigned ebits = m_ebits, sbits = m_sbits;
+        while (approximate && (ebits < info.m_max_ebits || sbits < info.m_max_sbits)) {
+            if (m.canceled())
+                throw tactic_exception(m.limit().get_cancel_msg());
+            ++m_stats.m_num_rounds;
+            model_ref mdl;
+            bool found = false;
+            try {
+                found = solve_approx(*g, info, ebits, sbits, mdl);
+            }
+            catch (unsupported) {
+                break;
+            }
+            IF_VERBOSE(10, verbose_stream() << "(qffp-approx :ebits " << ebits << " :sbits " << sbits << (found ? " :sat" : " :refine") << ")\n";);
+            if (found) {
+                ++m_stats.m_num_approx_sat;
+                if (g->models_enabled())
+                    g->add(model2model_converter(mdl.get()));
+                g->reset();
+                g->inc_depth();
+                result.push_back(g.get());
+                return;
+            }
+            ebits = std::min(info.m_max_ebits, ebits + 2);
+            sbits = std::min(info.m_max_sbits, 2 * sbits);
+        }
+        (*m_qffp)(g, result);
+    }
+
+    void cleanup() override {
+        m_qffp->cleanup();
+    }
+
+    void collect_statistics(statistics & st) const override {
+        st.update("fpa approx rounds", m_stats.m_num_rounds);
+        st.update("fpa approx sat", m_stats.m_num_approx_sat);
+        m_qffp->collect_statistics(st);
+    }
+
+    void reset_statistics() override {
+        m_stats.reset();
+        m_qffp->reset_statistics();
+    }
+};
+
+tactic * mk_fpa_approx_tactic(ast_manager & m, params_ref const & p) {
+    return alloc(fpa_approx_tactic, m, p);
+}
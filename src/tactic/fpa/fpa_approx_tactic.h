@@ -0,0 +1,33 @@
+/*++
+Copyright (c) 2019 Microsoft Corporation
+
+Module Name:
+
+    fpa_approx_tactic.h
+
+Abstract:
+
+    Precision-approximation tactic for QF_FP.
+
+    Floating-point terms are first solved with reduced exponent and
+    significand widths. A model of the reduced problem is lifted to the
+    original formats and checked at full precision; if the check fails, or
+    the reduced problem is unsatisfiable, the widths are increased until
+    the original precision is reached.
+
+Notes:
+
+--*/
+#ifndef FPA_APPROX_TACTIC_H_
+#define FPA_APPROX_TACTIC_H_
+
+#include "util/params.h"
+class ast_manager;
+class tactic;
+
+tactic * mk_fpa_approx_tactic(ast_manager & m, params_ref const & p = params_ref());
+/*
+  ADD_TACTIC("qffp-approx", "solve QF_FP problems by refining reduced-precision approximations.", "mk_fpa_approx_tactic(m, p)")
+*/
+
+#endif
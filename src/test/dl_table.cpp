@@ -6,6 +6,8 @@ Copyright (c) 2015 Microsoft Corporation
 #include "muz/rel/dl_table.h"
 #include "muz/fp/dl_register_engine.h"
 #include "muz/rel/dl_relation_manager.h"
+#include <algorithm>
+#include <vector>
 
 typedef datalog::table_base* (*mk_table_fn)(datalog::relation_manager& m, datalog::table_signature& sig);
 
@@ -95,6 +97,200 @@ void test_dl_bitvector_table() {
     test_table(mk_bv_table);
 }
 
+typedef std::vector<std::vector<datalog::table_element> > table_rows;
+
+static table_rows get_rows(datalog::table_base const& t) {
+    table_rows rows;
+    datalog::table_fact row;
+    for (auto const& r : t) {
+        r.get_fact(row);
+        rows.push_back(std::vector<datalog::table_element>(row.begin(), row.end()));
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+/**
+   \brief check that t has the same rows as the reference table ref, without duplicates.
+*/
+static void check_same(datalog::table_base const& t, datalog::table_base const& ref) {
+    table_rows rows = get_rows(t);
+    ENSURE(std::adjacent_find(rows.begin(), rows.end()) == rows.end());
+    ENSURE(rows == get_rows(ref));
+    ENSURE(t.get_size_estimate_rows() == rows.size());
+}
+
+static void add_random_facts(random_gen& r, unsigned n, datalog::table_base& t1, datalog::table_base& t2) {
+    datalog::table_signature const& sig = t1.get_signature();
+    datalog::table_fact row;
+    for (unsigned i = 0; i < n; ++i) {
+        row.reset();
+        for (unsigned j = 0; j < sig.size(); ++j)
+            row.push_back(r(static_cast<unsigned>(sig[j])));
+        t1.add_fact(row);
+        t2.add_fact(row);
+    }
+}
+
+//
+// The sorted table plugin is compared operation by operation against
+// the sparse table plugin on random tables with small column domains,
+// so that joins on one and two key columns produce matches and the
+// random facts contain duplicates.
+//
+static void test_dl_sorted_table() {
+    smt_params params;
+    ast_manager ast_m;
+    reg_decl_plugins(ast_m);
+    datalog::register_engine re;
+    datalog::context ctx(ast_m, re, params);
+    datalog::relation_manager & m = ctx.get_rel_context()->get_rmanager();
+    datalog::table_plugin * sorted = m.get_table_plugin(symbol("sorted"));
+    datalog::table_plugin * sparse = m.get_table_plugin(symbol("sparse"));
+    ENSURE(sorted && sparse);
+
+    datalog::table_signature sig;
+    sig.push_back(3);
+    sig.push_back(4);
+    sig.push_back(5);
+    random_gen r(0);
+
+    for (unsigned round = 0; round < 10; ++round) {
+        datalog::table_base* t1 = sorted->mk_empty(sig);
+        datalog::table_base* t2 = sorted->mk_empty(sig);
+        datalog::table_base* s1 = sparse->mk_empty(sig);
+        datalog::table_base* s2 = sparse->mk_empty(sig);
+        add_random_facts(r, 20 + r(20), *t1, *s1);
+        add_random_facts(r, 20 + r(20), *t2, *s2);
+        check_same(*t1, *s1);
+        check_same(*t2, *s2);
+
+        // joins on 0, 1 and 2 key columns.
+        unsigned cols1[2] = { 0, 2 };
+        unsigned cols2[2] = { 1, 0 };
+        for (unsigned col_cnt = 0; col_cnt <= 2; ++col_cnt) {
+            datalog::table_join_fn * jt = m.mk_join_fn(*t1, *t2, col_cnt, cols1, cols2);
+            datalog::table_join_fn * js = m.mk_join_fn(*s1, *s2, col_cnt, cols1, cols2);
+            datalog::table_base* jt1 = (*jt)(*t1, *t2);
+            datalog::table_base* js1 = (*js)(*s1, *s2);
+            check_same(*jt1, *js1);
+            jt1->deallocate();
+            js1->deallocate();
+            dealloc(jt);
+            dealloc(js);
+
+            unsigned removed[2] = { 1, 4 };
+            jt = m.mk_join_project_fn(*t1, *t2, col_cnt, cols1, cols2, 2, removed);
+            js = m.mk_join_project_fn(*s1, *s2, col_cnt, cols1, cols2, 2, removed);
+            jt1 = (*jt)(*t1, *t2);
+            js1 = (*js)(*s1, *s2);
+            check_same(*jt1, *js1);
+            jt1->deallocate();
+            js1->deallocate();
+            dealloc(jt);
+            dealloc(js);
+        }
+
+        // project and rename.
+        {
+            unsigned removed[1] = { 1 };
+            datalog::table_transformer_fn * pt = m.mk_project_fn(*t1, 1, removed);
+            datalog::table_transformer_fn * ps = m.mk_project_fn(*s1, 1, removed);
+            datalog::table_base* pt1 = (*pt)(*t1);
+            datalog::table_base* ps1 = (*ps)(*s1);
+            check_same(*pt1, *ps1);
+            pt1->deallocate();
+            ps1->deallocate();
+            dealloc(pt);
+            dealloc(ps);
+
+            unsigned cycle[3] = { 0, 2, 1 };
+            datalog::table_transformer_fn * rt = m.mk_rename_fn(*t2, 3, cycle);
+            datalog::table_transformer_fn * rs = m.mk_rename_fn(*s2, 3, cycle);
+            datalog::table_base* rt1 = (*rt)(*t2);
+            datalog::table_base* rs1 = (*rs)(*s2);
+            check_same(*rt1, *rs1);
+            rt1->deallocate();
+            rs1->deallocate();
+            dealloc(rt);
+            dealloc(rs);
+        }
+
+        // union without delta into a copy, and with delta into the original.
+        {
+            datalog::table_base* tc = t1->clone();
+            datalog::table_base* sc = s1->clone();
+            datalog::table_union_fn * ut = m.mk_union_fn(*tc, *t2);
+            datalog::table_union_fn * us = m.mk_union_fn(*sc, *s2);
+            (*ut)(*tc, *t2);
+            (*us)(*sc, *s2);
+            check_same(*tc, *sc);
+            dealloc(ut);
+            dealloc(us);
+            tc->deallocate();
+            sc->deallocate();
+
+            datalog::table_base* dt = sorted->mk_empty(sig);
+            datalog::table_base* ds = sparse->mk_empty(sig);
+            ut = m.mk_union_fn(*t1, *t2, dt);
+            us = m.mk_union_fn(*s1, *s2, ds);
+            (*ut)(*t1, *t2, dt);
+            (*us)(*s1, *s2, ds);
+            check_same(*t1, *s1);
+            check_same(*dt, *ds);
+            // a second union adds nothing.
+            dt->reset();
+            (*ut)(*t1, *t2, dt);
+            ENSURE(dt->empty());
+            check_same(*t1, *s1);
+            dealloc(ut);
+            dealloc(us);
+            dt->deallocate();
+            ds->deallocate();
+        }
+
+        // removal of present and absent facts, interleaved with additions.
+        {
+            table_rows rows = get_rows(*t2);
+            datalog::table_fact row;
+            for (unsigned i = 0; i < rows.size(); i += 3) {
+                row.reset();
+                row.append(static_cast<unsigned>(rows[i].size()), rows[i].data());
+                t2->remove_fact(row);
+                s2->remove_fact(row);
+                ENSURE(!t2->contains_fact(row));
+            }
+            add_random_facts(r, 5, *t2, *s2);
+            datalog::table_fact absent;
+            absent.push_back(2);
+            absent.push_back(3);
+            absent.push_back(4);
+            if (!s2->contains_fact(absent)) {
+                t2->remove_fact(absent);
+                ENSURE(!t2->contains_fact(absent));
+            }
+            check_same(*t2, *s2);
+            vector<datalog::table_fact> batch;
+            for (unsigned i = 1; i < rows.size(); i += 3) {
+                row.reset();
+                row.append(static_cast<unsigned>(rows[i].size()), rows[i].data());
+                batch.push_back(row);
+            }
+            t2->remove_facts(batch.size(), batch.c_ptr());
+            s2->remove_facts(batch.size(), batch.c_ptr());
+            check_same(*t2, *s2);
+            for (auto const& f : batch)
+                ENSURE(!t2->contains_fact(f));
+        }
+
+        t1->deallocate();
+        t2->deallocate();
+        s1->deallocate();
+        s2->deallocate();
+    }
+}
+
 void tst_dl_table() {
     test_dl_bitvector_table();
+    test_dl_sorted_table();
 }
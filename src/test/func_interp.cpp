@@ -0,0 +1,78 @@
+#include "model/func_interp.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/reg_decl_plugins.h"
+#include "ast/ast_pp.h"
+
+//
+// get_entry switches from a linear search to an index on argument tuples
+// once a function interpretation has enough entries. Check that lookups
+// agree with the entries inserted, before and after the index is built,
+// after entries are overwritten, and after compress removes some of them.
+//
+static void check_entries(ast_manager & m, func_interp const & fi, expr_ref_vector const & keys1,
+                          expr_ref_vector const & keys2, expr_ref_vector const & results) {
+    for (unsigned i = 0; i < keys1.size(); ++i) {
+        expr * args[2] = { keys1.get(i), keys2.get(i) };
+        func_entry * e = fi.get_entry(args);
+        if (results.get(i) == nullptr) {
+            ENSURE(e == nullptr);
+            continue;
+        }
+        ENSURE(e != nullptr);
+        ENSURE(e->get_result() == results.get(i));
+    }
+}
+
+void tst_func_interp() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    sort * sI = a.mk_int();
+    expr_ref c(m.mk_const(symbol("c"), sI), m);
+
+    func_interp fi(m, 2);
+    expr_ref_vector keys1(m), keys2(m), results(m);
+    unsigned n = 40;
+    for (unsigned i = 0; i < n; ++i) {
+        // the entry for i = 5 has a non-value argument and is only found by the linear search.
+        expr * k1 = i == 5 ? c.get() : a.mk_int(i);
+        expr * k2 = a.mk_int(i % 3);
+        expr * r  = a.mk_int(i % 4);
+        expr * args[2] = { k1, k2 };
+        fi.insert_entry(args, r);
+        keys1.push_back(k1);
+        keys2.push_back(k2);
+        results.push_back(r);
+        check_entries(m, fi, keys1, keys2, results);
+    }
+    ENSURE(fi.num_entries() == n);
+
+    // overwrite results through the index.
+    for (unsigned i = 0; i < n; i += 7) {
+        expr * args[2] = { keys1.get(i), keys2.get(i) };
+        expr * r = a.mk_int(100 + i);
+        fi.insert_entry(args, r);
+        results.set(i, r);
+    }
+    ENSURE(fi.num_entries() == n);
+    check_entries(m, fi, keys1, keys2, results);
+
+    // missing tuples.
+    {
+        expr * args[2] = { a.mk_int(1), a.mk_int(2) };
+        ENSURE(fi.get_entry(args) == nullptr);
+        expr * args2[2] = { c.get(), a.mk_int(0) };
+        ENSURE(fi.get_entry(args2) == nullptr);
+    }
+
+    // compress drops the entries whose result is the else value,
+    // and the remaining entries stay reachable.
+    expr_ref r0(a.mk_int(0), m);
+    fi.set_else(r0);
+    fi.compress();
+    for (unsigned i = 0; i < n; ++i)
+        if (results.get(i) == r0)
+            results.set(i, nullptr);
+    ENSURE(fi.num_entries() < n);
+    check_entries(m, fi, keys1, keys2, results);
+}
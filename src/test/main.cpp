@@ -247,7 +247,11 @@ int main(int argc, char ** argv) {
     TST_ARGV(ddnf);
     TST(ddnf1);
     TST(model_evaluator);
+    TST(func_interp);
+    TST(model_eval_batch);
+    TST(user_propagator);
     TST(get_consequences);
+    TST(maxres);
     TST(pb2bv);
     TST_ARGV(sat_lookahead);
     TST_ARGV(sat_local_search);
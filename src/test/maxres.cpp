@@ -0,0 +1,147 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    maxres.cpp
+
+Abstract:
+
+    Compare the optimum found by the core-guided MaxSAT engines, with and
+    without incremental totalizers, against exhaustive enumeration.
+
+--*/
+
+#include "api/z3.h"
+#include "util/trace.h"
+#include "util/debug.h"
+#include "util/vector.h"
+#include "util/util.h"
+#include <string>
+
+struct maxsat_clause {
+    svector<int> m_lits;    // variable index + 1, negative for negated literals
+    unsigned     m_weight;
+};
+
+static bool is_sat(maxsat_clause const& c, unsigned assignment) {
+    for (int l : c.m_lits) {
+        bool val = (assignment & (1u << (abs(l) - 1))) != 0;
+        if ((l > 0) == val)
+            return true;
+    }
+    return false;
+}
+
+static maxsat_clause mk_clause(random_gen& r, unsigned num_vars, unsigned len, unsigned weight) {
+    maxsat_clause c;
+    for (unsigned i = 0; i < len; ++i) {
+        int v = 1 + r(num_vars);
+        c.m_lits.push_back(r(2) ? v : -v);
+    }
+    c.m_weight = weight;
+    return c;
+}
+
+static Z3_ast mk_clause(Z3_context ctx, Z3_ast const* vars, maxsat_clause const& c) {
+    svector<Z3_ast> lits;
+    for (int l : c.m_lits)
+        lits.push_back(l > 0 ? vars[l - 1] : Z3_mk_not(ctx, vars[-l - 1]));
+    return Z3_mk_or(ctx, lits.size(), lits.c_ptr());
+}
+
+/**
+   \brief minimal cost of the soft clauses over the assignments that satisfy the hard clauses,
+   or UINT_MAX if the hard clauses are unsatisfiable.
+*/
+static unsigned brute_force(unsigned num_vars, vector<maxsat_clause> const& hard, vector<maxsat_clause> const& soft) {
+    unsigned best = UINT_MAX;
+    for (unsigned a = 0; a < (1u << num_vars); ++a) {
+        bool ok = true;
+        for (auto const& c : hard)
+            ok = ok && is_sat(c, a);
+        if (!ok)
+            continue;
+        unsigned cost = 0;
+        for (auto const& c : soft)
+            if (!is_sat(c, a))
+                cost += c.m_weight;
+        if (cost < best)
+            best = cost;
+    }
+    return best;
+}
+
+static unsigned solve(char const* engine, bool totalizer, unsigned num_vars,
+                      vector<maxsat_clause> const& hard, vector<maxsat_clause> const& soft) {
+    Z3_config cfg = Z3_mk_config();
+    Z3_context ctx = Z3_mk_context(cfg);
+    Z3_del_config(cfg);
+    Z3_optimize opt = Z3_mk_optimize(ctx);
+    Z3_optimize_inc_ref(ctx, opt);
+    Z3_params p = Z3_mk_params(ctx);
+    Z3_params_inc_ref(ctx, p);
+    Z3_params_set_symbol(ctx, p, Z3_mk_string_symbol(ctx, "maxsat_engine"), Z3_mk_string_symbol(ctx, engine));
+    Z3_params_set_bool(ctx, p, Z3_mk_string_symbol(ctx, "maxres.incremental_totalizer"), totalizer);
+    Z3_optimize_set_params(ctx, opt, p);
+    Z3_params_dec_ref(ctx, p);
+
+    svector<Z3_ast> vars;
+    for (unsigned i = 0; i < num_vars; ++i) {
+        std::string name = "x" + std::to_string(i);
+        vars.push_back(Z3_mk_const(ctx, Z3_mk_string_symbol(ctx, name.c_str()), Z3_mk_bool_sort(ctx)));
+    }
+    for (auto const& c : hard)
+        Z3_optimize_assert(ctx, opt, mk_clause(ctx, vars.c_ptr(), c));
+    Z3_symbol id = Z3_mk_string_symbol(ctx, "soft");
+    for (auto const& c : soft) {
+        std::string w = std::to_string(c.m_weight);
+        Z3_optimize_assert_soft(ctx, opt, mk_clause(ctx, vars.c_ptr(), c), w.c_str(), id);
+    }
+
+    unsigned cost = UINT_MAX;
+    Z3_lbool r = Z3_optimize_check(ctx, opt, 0, nullptr);
+    ENSURE(r != Z3_L_UNDEF);
+    if (r == Z3_L_TRUE) {
+        Z3_model mdl = Z3_optimize_get_model(ctx, opt);
+        Z3_model_inc_ref(ctx, mdl);
+        cost = 0;
+        for (auto const& c : soft) {
+            Z3_ast v = nullptr;
+            ENSURE(Z3_model_eval(ctx, mdl, mk_clause(ctx, vars.c_ptr(), c), true, &v));
+            if (Z3_get_bool_value(ctx, v) != Z3_L_TRUE)
+                cost += c.m_weight;
+        }
+        for (auto const& c : hard) {
+            Z3_ast v = nullptr;
+            ENSURE(Z3_model_eval(ctx, mdl, mk_clause(ctx, vars.c_ptr(), c), true, &v));
+            ENSURE(Z3_get_bool_value(ctx, v) == Z3_L_TRUE);
+        }
+        Z3_model_dec_ref(ctx, mdl);
+    }
+    Z3_optimize_dec_ref(ctx, opt);
+    Z3_del_context(ctx);
+    return cost;
+}
+
+void tst_maxres() {
+    random_gen r(0);
+    char const* engines[2] = { "maxres", "pd-maxres" };
+    for (unsigned round = 0; round < 20; ++round) {
+        unsigned num_vars = 6 + r(5);
+        vector<maxsat_clause> hard, soft;
+        for (unsigned i = 0; i < num_vars; ++i)
+            hard.push_back(mk_clause(r, num_vars, 3, 0));
+        for (unsigned i = 0; i < 3 * num_vars; ++i)
+            // odd rounds use weighted soft constraints.
+            soft.push_back(mk_clause(r, num_vars, 1 + r(2), round % 2 == 0 ? 1 : 1 + r(4)));
+        unsigned best = brute_force(num_vars, hard, soft);
+        for (char const* engine : engines) {
+            for (bool totalizer : { false, true }) {
+                unsigned cost = solve(engine, totalizer, num_vars, hard, soft);
+                TRACE("maxres", tout << engine << " totalizer: " << totalizer << " " << cost << " " << best << "\n";);
+                ENSURE(cost == best);
+            }
+        }
+    }
+}
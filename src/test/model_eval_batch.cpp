@@ -0,0 +1,117 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    model_eval_batch.cpp
+
+Abstract:
+
+    Check that Z3_model_eval_batch agrees with Z3_model_eval term by term.
+
+--*/
+
+#include "api/z3.h"
+#include "util/trace.h"
+#include "util/debug.h"
+#include "util/vector.h"
+
+static Z3_ast mk_int_var(Z3_context ctx, char const* name) {
+    return Z3_mk_const(ctx, Z3_mk_string_symbol(ctx, name), Z3_mk_int_sort(ctx));
+}
+
+static Z3_ast mk_int(Z3_context ctx, int v) {
+    return Z3_mk_int(ctx, v, Z3_mk_int_sort(ctx));
+}
+
+void tst_model_eval_batch() {
+    Z3_config cfg = Z3_mk_config();
+    Z3_context ctx = Z3_mk_context(cfg);
+    Z3_del_config(cfg);
+    Z3_sort int_ty = Z3_mk_int_sort(ctx);
+    Z3_sort arr_ty = Z3_mk_array_sort(ctx, int_ty, int_ty);
+    Z3_ast x = mk_int_var(ctx, "x");
+    Z3_ast y = mk_int_var(ctx, "y");
+    Z3_ast z = mk_int_var(ctx, "z");   // not constrained, absent from the models
+    Z3_ast a = Z3_mk_const(ctx, Z3_mk_string_symbol(ctx, "a"), arr_ty);
+    Z3_ast b = Z3_mk_const(ctx, Z3_mk_string_symbol(ctx, "b"), Z3_mk_bool_sort(ctx));
+    Z3_func_decl f = Z3_mk_func_decl(ctx, Z3_mk_string_symbol(ctx, "f"), 1, &int_ty, int_ty);
+    Z3_ast fx = Z3_mk_app(ctx, f, 1, &x);
+    Z3_ast fy = Z3_mk_app(ctx, f, 1, &y);
+
+    Z3_solver s = Z3_mk_simple_solver(ctx);
+    Z3_solver_inc_ref(ctx, s);
+    Z3_ast args[2] = { x, y };
+    Z3_solver_assert(ctx, s, Z3_mk_gt(ctx, Z3_mk_add(ctx, 2, args), mk_int(ctx, 3)));
+    Z3_solver_assert(ctx, s, Z3_mk_not(ctx, Z3_mk_eq(ctx, fx, fy)));
+    Z3_solver_assert(ctx, s, Z3_mk_gt(ctx, Z3_mk_select(ctx, a, x), mk_int(ctx, 2)));
+    Z3_ast xy[2] = { x, y };
+    Z3_solver_assert(ctx, s, Z3_mk_distinct(ctx, 2, xy));
+
+    // collect a few different models by blocking the values of x and y.
+    svector<Z3_model> models;
+    for (unsigned i = 0; i < 4 && Z3_solver_check(ctx, s) == Z3_L_TRUE; ++i) {
+        Z3_model mdl = Z3_solver_get_model(ctx, s);
+        Z3_model_inc_ref(ctx, mdl);
+        models.push_back(mdl);
+        Z3_ast vx = nullptr, vy = nullptr;
+        ENSURE(Z3_model_eval(ctx, mdl, x, true, &vx));
+        ENSURE(Z3_model_eval(ctx, mdl, y, true, &vy));
+        Z3_ast block[2] = { Z3_mk_not(ctx, Z3_mk_eq(ctx, x, vx)), Z3_mk_not(ctx, Z3_mk_eq(ctx, y, vy)) };
+        Z3_solver_assert(ctx, s, Z3_mk_or(ctx, 2, block));
+    }
+    ENSURE(models.size() == 4);
+
+    // terms share subterms and mix arithmetic, uninterpreted functions,
+    // arrays, Booleans, a quantifier and a constant without interpretation.
+    Z3_ast ffy = Z3_mk_app(ctx, f, 1, &fy);
+    Z3_ast xz[2] = { x, z };
+    Z3_ast xfx[2] = { x, fx };
+    Z3_symbol qn = Z3_mk_string_symbol(ctx, "q");
+    Z3_ast q = Z3_mk_bound(ctx, 0, int_ty);
+    Z3_ast qx[2] = { q, x };
+    Z3_ast b_or_lt[2] = { b, Z3_mk_lt(ctx, fx, fy) };
+    Z3_ast ex = Z3_mk_exists(ctx, 0, 0, nullptr, 1, &int_ty, &qn, Z3_mk_gt(ctx, Z3_mk_add(ctx, 2, qx), y));
+    Z3_ast terms[] = {
+        Z3_mk_add(ctx, 2, args),
+        fx,
+        ffy,
+        Z3_mk_mul(ctx, 2, xfx),
+        Z3_mk_ite(ctx, Z3_mk_gt(ctx, x, y), fx, ffy),
+        Z3_mk_select(ctx, Z3_mk_store(ctx, a, y, fx), x),
+        Z3_mk_select(ctx, a, Z3_mk_add(ctx, 2, args)),
+        Z3_mk_or(ctx, 2, b_or_lt),
+        Z3_mk_add(ctx, 2, xz),
+        ex,
+    };
+    unsigned num_terms = sizeof(terms) / sizeof(terms[0]);
+    Z3_ast_vector ts = Z3_mk_ast_vector(ctx);
+    Z3_ast_vector_inc_ref(ctx, ts);
+    for (unsigned j = 0; j < num_terms; ++j)
+        Z3_ast_vector_push(ctx, ts, terms[j]);
+
+    for (bool completion : { false, true }) {
+        Z3_ast_vector vals = Z3_model_eval_batch(ctx, ts, models.size(), models.c_ptr(), completion);
+        ENSURE(vals);
+        Z3_ast_vector_inc_ref(ctx, vals);
+        ENSURE(Z3_ast_vector_size(ctx, vals) == models.size() * num_terms);
+        for (unsigned i = 0; i < models.size(); ++i) {
+            for (unsigned j = 0; j < num_terms; ++j) {
+                Z3_ast expected = nullptr;
+                ENSURE(Z3_model_eval(ctx, models[i], terms[j], completion, &expected));
+                Z3_ast actual = Z3_ast_vector_get(ctx, vals, i * num_terms + j);
+                TRACE("model_eval_batch", tout << Z3_ast_to_string(ctx, terms[j]) << " ";
+                      tout << Z3_ast_to_string(ctx, expected) << " ";
+                      tout << Z3_ast_to_string(ctx, actual) << "\n";);
+                ENSURE(Z3_is_eq_ast(ctx, expected, actual));
+            }
+        }
+        Z3_ast_vector_dec_ref(ctx, vals);
+    }
+
+    Z3_ast_vector_dec_ref(ctx, ts);
+    for (Z3_model mdl : models)
+        Z3_model_dec_ref(ctx, mdl);
+    Z3_solver_dec_ref(ctx, s);
+    Z3_del_context(ctx);
+}
@@ -6,6 +6,139 @@ Copyright (c) 2015 Microsoft Corporation
 
 #include "smt/smt_context.h"
 #include "ast/reg_decl_plugins.h"
+#include "ast/array_decl_plugin.h"
+#include "ast/arith_decl_plugin.h"
+#include "util/util.h"
+#include <functional>
+
+/**
+   select(store(a, 0, 0, 5), i, j) != select(a, i, j) with i = 0 and j != 0
+   is unsat. With lazy store axioms, the equal first index must not be taken
+   as a witness that the read-over-write axiom holds.
+*/
+static void tst_lazy_store_axioms(bool lazy) {
+    smt_params params;
+    params.m_array_lazy_store_axioms = lazy;
+    ast_manager m;
+    reg_decl_plugins(m);
+    array_util au(m);
+    arith_util a(m);
+    sort * int_s = a.mk_int();
+    sort * dom[2] = { int_s, int_s };
+    sort_ref arr_s(au.mk_array_sort(2, dom, int_s), m);
+    app_ref arr(m.mk_const(symbol("a"), arr_s), m);
+    app_ref i(m.mk_const(symbol("i"), int_s), m);
+    app_ref j(m.mk_const(symbol("j"), int_s), m);
+    expr_ref zero(a.mk_int(0), m), five(a.mk_int(5), m);
+    expr * st_args[4] = { arr, zero, zero, five };
+    expr_ref st(au.mk_store(4, st_args), m);
+    expr * sel1_args[3] = { st, i, j };
+    expr * sel2_args[3] = { arr, i, j };
+    expr_ref sel1(au.mk_select(3, sel1_args), m);
+    expr_ref sel2(au.mk_select(3, sel2_args), m);
+
+    smt::context ctx(m, params);
+    ctx.assert_expr(m.mk_eq(i, zero));
+    ctx.assert_expr(m.mk_not(m.mk_eq(j, zero)));
+    ctx.assert_expr(m.mk_not(m.mk_eq(sel1, sel2)));
+    ENSURE(ctx.check() == l_false);
+}
+
+static app * mk_select(array_util & au, expr * a, expr * i) {
+    expr * args[2] = { a, i };
+    return au.mk_select(2, args);
+}
+
+static app * mk_store(array_util & au, expr * a, expr * i, expr * v) {
+    expr * args[3] = { a, i, v };
+    return au.mk_store(3, args);
+}
+
+/**
+   select(a, j) = 1, select(b, j) = 2, i != j and store(a, i, 0) = store(b, i, 0)
+   is unsat. No select is applied to a store, so the conflict is only found through
+   the pairs produced by upward propagation.
+*/
+static void tst_lazy_store_axioms_upward(bool lazy) {
+    smt_params params;
+    params.m_array_lazy_store_axioms = lazy;
+    ast_manager m;
+    reg_decl_plugins(m);
+    array_util au(m);
+    arith_util a(m);
+    sort * int_s = a.mk_int();
+    sort_ref arr_s(au.mk_array_sort(int_s, int_s), m);
+    app_ref arr1(m.mk_const(symbol("a"), arr_s), m);
+    app_ref arr2(m.mk_const(symbol("b"), arr_s), m);
+    app_ref i(m.mk_const(symbol("i"), int_s), m);
+    app_ref j(m.mk_const(symbol("j"), int_s), m);
+    expr_ref zero(a.mk_int(0), m), one(a.mk_int(1), m), two(a.mk_int(2), m);
+
+    smt::context ctx(m, params);
+    ctx.assert_expr(m.mk_eq(mk_select(au, arr1, j), one));
+    ctx.assert_expr(m.mk_eq(mk_select(au, arr2, j), two));
+    ctx.assert_expr(m.mk_not(m.mk_eq(i, j)));
+    ctx.assert_expr(m.mk_eq(mk_store(au, arr1, i, zero), mk_store(au, arr2, i, zero)));
+    ENSURE(ctx.check() == l_false);
+}
+
+/**
+   Random clauses over nested stores and selects must get the same answer
+   with and without lazy store axioms.
+*/
+static void tst_lazy_store_axioms_random() {
+    random_gen r(0);
+    for (unsigned round = 0; round < 100; ++round) {
+        ast_manager m;
+        reg_decl_plugins(m);
+        array_util au(m);
+        arith_util a(m);
+        sort * int_s = a.mk_int();
+        sort_ref arr_s(au.mk_array_sort(int_s, int_s), m);
+        expr_ref_vector arrs(m), idxs(m), fmls(m);
+        for (char const* n : { "a", "b", "c" })
+            arrs.push_back(m.mk_const(symbol(n), arr_s));
+        for (char const* n : { "i", "j", "k" })
+            idxs.push_back(m.mk_const(symbol(n), int_s));
+        idxs.push_back(a.mk_int(0));
+        idxs.push_back(a.mk_int(1));
+        auto mk_idx = [&]() { return expr_ref(idxs.get(r(idxs.size())), m); };
+        std::function<expr_ref(unsigned)> mk_arr, mk_val;
+        mk_arr = [&](unsigned d) {
+            if (d == 0 || r(5) < 2)
+                return expr_ref(arrs.get(r(arrs.size())), m);
+            expr_ref a1 = mk_arr(d - 1), i1 = mk_idx(), v1 = mk_val(d - 1);
+            return expr_ref(mk_store(au, a1, i1, v1), m);
+        };
+        mk_val = [&](unsigned d) {
+            if (d == 0 || r(2) == 0)
+                return r(2) == 0 ? mk_idx() : expr_ref(a.mk_int(r(3)), m);
+            expr_ref a1 = mk_arr(d - 1), i1 = mk_idx();
+            return expr_ref(mk_select(au, a1, i1), m);
+        };
+        unsigned num_clauses = 4 + r(6);
+        for (unsigned c = 0; c < num_clauses; ++c) {
+            expr_ref_vector lits(m);
+            for (unsigned l = 1 + r(2); l-- > 0; ) {
+                expr_ref lhs = r(2) ? mk_arr(2) : mk_val(2);
+                expr_ref rhs = au.is_array(lhs) ? mk_arr(2) : mk_val(2);
+                expr_ref eq(m.mk_eq(lhs, rhs), m);
+                lits.push_back(r(5) < 2 ? m.mk_not(eq) : eq.get());
+            }
+            fmls.push_back(m.mk_or(lits.size(), lits.c_ptr()));
+        }
+        lbool results[2];
+        for (bool lazy : { false, true }) {
+            smt_params params;
+            params.m_array_lazy_store_axioms = lazy;
+            smt::context ctx(m, params);
+            for (expr * f : fmls)
+                ctx.assert_expr(f);
+            results[lazy] = ctx.check();
+        }
+        ENSURE(results[0] == results[1]);
+    }
+}
 
 void tst_smt_context()
 {
@@ -32,4 +165,10 @@ void tst_smt_context()
     }
 
     ctx.check();
+
+    tst_lazy_store_axioms(false);
+    tst_lazy_store_axioms(true);
+    tst_lazy_store_axioms_upward(false);
+    tst_lazy_store_axioms_upward(true);
+    tst_lazy_store_axioms_random();
 }
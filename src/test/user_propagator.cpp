@@ -0,0 +1,99 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    user_propagator.cpp
+
+Abstract:
+
+    Check that attaching a user propagator keeps the solver sound: assertions,
+    registered terms and propagated consequences are all rewritten before
+    they reach the SMT core.
+
+--*/
+
+#include "api/z3.h"
+#include "util/trace.h"
+#include "util/debug.h"
+#include "util/util.h"
+
+struct user_prop_state {
+    Z3_context m_ctx;
+    unsigned   m_id;        // registered term that triggers the propagation
+    Z3_ast     m_conseq;    // consequence propagated when it is true
+    unsigned   m_num_fixed;
+};
+
+static void push_eh(void*) {}
+static void pop_eh(void*, unsigned) {}
+
+static void fixed_eh(void* _s, Z3_solver_callback cb, unsigned id, Z3_ast value) {
+    user_prop_state* s = static_cast<user_prop_state*>(_s);
+    s->m_num_fixed++;
+    if (id == s->m_id && Z3_get_bool_value(s->m_ctx, value) == Z3_L_TRUE)
+        Z3_solver_propagate_consequence(s->m_ctx, cb, 1, &id, 0, nullptr, nullptr, s->m_conseq);
+}
+
+static Z3_ast mk_int_var(Z3_context ctx, char const* name) {
+    return Z3_mk_const(ctx, Z3_mk_string_symbol(ctx, name), Z3_mk_int_sort(ctx));
+}
+
+static Z3_ast mk_int(Z3_context ctx, int v) {
+    return Z3_mk_int(ctx, v, Z3_mk_int_sort(ctx));
+}
+
+void tst_user_propagator() {
+    Z3_config cfg = Z3_mk_config();
+    Z3_context ctx = Z3_mk_context(cfg);
+    Z3_del_config(cfg);
+    Z3_ast x = mk_int_var(ctx, "x");
+    Z3_ast y = mk_int_var(ctx, "y");
+    Z3_ast b = Z3_mk_const(ctx, Z3_mk_string_symbol(ctx, "b"), Z3_mk_bool_sort(ctx));
+
+    // preprocessing stays on once a propagator is attached.
+    {
+        Z3_solver s = Z3_mk_solver(ctx);
+        Z3_solver_inc_ref(ctx, s);
+        user_prop_state st = { ctx, UINT_MAX, nullptr, 0 };
+        Z3_solver_propagate_init(ctx, s, &st, push_eh, pop_eh);
+        Z3_solver_assert(ctx, s, Z3_mk_gt(ctx, x, mk_int(ctx, 5)));
+        Z3_solver_assert(ctx, s, Z3_mk_lt(ctx, x, mk_int(ctx, 3)));
+        ENSURE(Z3_solver_check(ctx, s) == Z3_L_FALSE);
+        Z3_solver_dec_ref(ctx, s);
+    }
+
+    // b implies x > 5 through the propagator; the consequence is not in normal form.
+    for (bool assert_b : { false, true }) {
+        Z3_solver s = Z3_mk_solver(ctx);
+        Z3_solver_inc_ref(ctx, s);
+        user_prop_state st = { ctx, 0, Z3_mk_gt(ctx, x, mk_int(ctx, 5)), 0 };
+        Z3_solver_propagate_init(ctx, s, &st, push_eh, pop_eh);
+        Z3_solver_propagate_fixed(ctx, s, fixed_eh);
+        st.m_id = Z3_solver_propagate_register(ctx, s, b);
+        Z3_solver_assert(ctx, s, Z3_mk_lt(ctx, x, mk_int(ctx, 3)));
+        if (assert_b)
+            Z3_solver_assert(ctx, s, b);
+        Z3_lbool r = Z3_solver_check(ctx, s);
+        TRACE("user_propagator", tout << assert_b << " " << r << " " << st.m_num_fixed << "\n";);
+        ENSURE(r == (assert_b ? Z3_L_FALSE : Z3_L_TRUE));
+        ENSURE(st.m_num_fixed > 0);
+        Z3_solver_dec_ref(ctx, s);
+    }
+
+    // the registered term x > 10 is not in normal form either.
+    {
+        Z3_solver s = Z3_mk_solver(ctx);
+        Z3_solver_inc_ref(ctx, s);
+        user_prop_state st = { ctx, 0, Z3_mk_lt(ctx, y, mk_int(ctx, 0)), 0 };
+        Z3_solver_propagate_init(ctx, s, &st, push_eh, pop_eh);
+        Z3_solver_propagate_fixed(ctx, s, fixed_eh);
+        st.m_id = Z3_solver_propagate_register(ctx, s, Z3_mk_gt(ctx, x, mk_int(ctx, 10)));
+        Z3_solver_assert(ctx, s, Z3_mk_eq(ctx, x, mk_int(ctx, 20)));
+        Z3_solver_assert(ctx, s, Z3_mk_ge(ctx, y, mk_int(ctx, 0)));
+        ENSURE(Z3_solver_check(ctx, s) == Z3_L_FALSE);
+        Z3_solver_dec_ref(ctx, s);
+    }
+
+    Z3_del_context(ctx);
+}